@@ -0,0 +1,106 @@
+/**
+ * @file adisolver.h
+ * @brief Axisymmetric 2-D conduction along the generatrix of the blunted cone.
+ * @copyright MIT License
+ */
+
+#ifndef _ADISOLVER_H_
+#define _ADISOLVER_H_
+
+#include <common.h>
+#include <model.h>
+#include <tdma.h>
+#include <bluntedcone.h>
+#include <threadpool.h>
+
+/**
+ * @brief Solver of the 2-D (through-thickness x along-generatrix) conduction
+ * by Strang operator splitting.
+ * @details Each station along the generatrix has its own 1-D model. The
+ * through-thickness sweep is made by the caller's task (the solvers of the
+ * stations, with their own heat flux). The lateral sweep solves
+ * a tridiagonal system along the generatrix for each cell number of the
+ * models, with the axisymmetric shell metric: face areas and volumes are
+ * proportional to the surface radius. Sweeps are split symmetrically (half
+ * lateral step, thickness step, half lateral step), line solves of each sweep
+ * run in parallel on the thread pool.
+ */
+class CADISolver {
+	/** Geometry of the vehicle. */
+	CBluntedCone* cone;
+	/** Pool of threads for the line solves. */
+	CThreadPool* pool;
+	/** Models of the stations. */
+	vector<thm_t*> thm;
+	/** Axis coordinates of the stations, [m]. */
+	vector<double> X;
+	/** Generatrix coordinates of the stations, [m]. */
+	vector<double> G;
+	/** Surface radii of the stations, [m]. */
+	vector<double> RS;
+	/** Workspace of the lateral line solves. */
+	CArena arena;
+	/** Tridiagonal solvers, one per thread. */
+	vector<CTDMASolver*> tdma;
+	/** Coefficients of the lateral systems, STATIONS elements per thread. */
+	double *A, *B, *C, *F, *T;
+	/** Number of stations the workspace is sized for. */
+	int CAPACITY;
+	/** End of the current through-thickness sweep. */
+	double TARGET;
+	/** Size the workspace for the current number of stations. */
+	void allocate();
+	/* Solver owns its workspace and can't be copied. */
+	CADISolver(const CADISolver&);
+	CADISolver& operator=(const CADISolver&);
+public:
+	/**
+	 * @brief Class constructor.
+	 * @param cone - geometry of the vehicle.
+	 * @param pool - pool of threads.
+	 */
+	CADISolver(CBluntedCone* cone, CThreadPool* pool);
+	/** Class destructor. */
+	~CADISolver();
+	/**
+	 * @brief Add station. Stations must be added in ascending order of x.
+	 * @details All models must be copies of one model: lateral neighbours are
+	 * the cells with the same number.
+	 * @param x - axis coordinate of the station, [m].
+	 * @param thm - model of the station.
+	 * @return Station number.
+	 */
+	int add(double x, thm_t* thm);
+	/** Return number of stations. */
+	int count() const;
+	/** Return model of the station. */
+	thm_t* station(int s);
+	/** Return axis coordinate of the station, [m]. */
+	double x(int s) const;
+	/** Return end of the current through-thickness sweep. */
+	double target() const;
+	/**
+	 * @brief Lateral sweep over the time step thau for all cell numbers.
+	 * @param thau - time step.
+	 */
+	void Lateral(double thau);
+	/**
+	 * @brief Lateral solve for one cell number.
+	 * @details Stations where the cell is ablated split the line into
+	 * independent pieces with insulated ends.
+	 * @param i - cell number.
+	 * @param thread - number of the executing thread.
+	 * @param thau - time step.
+	 */
+	void Line(int i, int thread, double thau);
+	/**
+	 * @brief Solve the 2-D task from CURRENT_TIME of the stations to time.
+	 * @param time - next stop point of timeline.
+	 * @param STEP - splitting step.
+	 * @param thickness - task of the through-thickness sweep: run(s) must
+	 * advance the station s to target().
+	 */
+	void Solve(double time, double STEP, CTask* thickness);
+};
+
+#endif /* _ADISOLVER_H_ */
@@ -0,0 +1,29 @@
+/**
+ * @file alloccount.h
+ * @brief Counter of heap allocations for checking the time march.
+ * @details Built with AVD_COUNT_ALLOCS defined (make CC="g++ -DAVD_COUNT_ALLOCS"),
+ * the global operator new and, with glibc, malloc(), calloc(), realloc(),
+ * aligned_alloc(), memalign() and posix_memalign() count their calls in each
+ * thread, and every step of AVDSolver asserts that it made no allocations.
+ * Otherwise the checks compile to nothing.
+ * @copyright MIT License
+ */
+
+#ifndef _ALLOCCOUNT_H_
+#define _ALLOCCOUNT_H_
+
+#include <common.h>
+
+#ifdef AVD_COUNT_ALLOCS
+/** Return number of allocations made by the calling thread. */
+long alloc_count();
+/** Remember the number of allocations of the thread in the variable v. */
+#define ALLOC_MARK(v)	const long v = alloc_count()
+/** Check that the thread made no allocations since ALLOC_MARK(v). */
+#define ALLOC_CHECK(v)	assert(alloc_count() == v)
+#else
+#define ALLOC_MARK(v)
+#define ALLOC_CHECK(v)
+#endif
+
+#endif /* _ALLOCCOUNT_H_ */
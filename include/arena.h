@@ -0,0 +1,68 @@
+/**
+ * @file arena.h
+ * @brief Contiguous aligned storage for the model and solver arrays.
+ * @copyright MIT License
+ */
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <cstddef>
+
+/** Alignment of each array in the arena, bytes (enough for AVX-512 loads). */
+#define ARENA_ALIGN		(64)
+
+/**
+ * @brief Arena of aligned arrays.
+ * @details One block of memory is allocated by reserve(); arrays are cut from it
+ * by alloc() one after another, each aligned to ARENA_ALIGN bytes. All arrays
+ * are released together when the arena is reserved again or destroyed.
+ */
+class CArena {
+	/** Begin of the memory block. */
+	char* base;
+	/** Size of the memory block, bytes. */
+	size_t SIZE;
+	/** Used part of the memory block, bytes. */
+	size_t used;
+	/* Arena owns its memory block and can't be copied. */
+	CArena(const CArena&);
+	CArena& operator=(const CArena&);
+public:
+	/** Class constructor. Creates empty arena. */
+	CArena();
+	/** Class destructor. */
+	~CArena();
+	/**
+	 * @brief Size of the array in the arena, with alignment padding.
+	 * @param bytes - size of the array, bytes.
+	 */
+	static size_t align(size_t bytes);
+	/**
+	 * @brief Allocate new memory block. All previously allocated arrays are released.
+	 * @param bytes - size of the memory block, bytes.
+	 */
+	void reserve(size_t bytes);
+	/** Release all arrays, keeping the memory block for reuse. */
+	void reset();
+	/**
+	 * @brief Cut an aligned array from the memory block.
+	 * @param bytes - size of the array, bytes.
+	 * @return Pointer to the array.
+	 */
+	void* alloc(size_t bytes);
+	/**
+	 * @brief Cut an aligned array of n elements from the memory block.
+	 * @param n - number of elements.
+	 */
+	template <class T> T* alloc(int n)
+	{
+		return (T*)alloc(n*sizeof(T));
+	}
+	/** Exchange memory blocks of two arenas. */
+	void swap(CArena& arena);
+	/** Return size of the memory block, bytes. */
+	size_t size() const;
+};
+
+#endif /* _ARENA_H_ */
@@ -192,4 +192,42 @@ double sa_AverageAirParticlesPassing(double H);
  */
 double sa_AirPartsShockFrequency(double H);
 
+/**
+ * @brief Параметры атмосферы для газодинамического расчёта
+ * @details Высоты: от минус 2000 м. Если включена плотная таблица
+ * (BCA_Dense), значения внутри неё интерполируются линейно, вне её
+ * вычисляются по слоям.
+ * @param H - высота над уровнем моря [м].
+ * @param T - температура [К].
+ * @param P - давление [кгс/м^2].
+ * @param rho - плотность [кгс*с^2/м^4].
+ * @param a - скорость звука [м/с].
+ */
+void BCA(double H, double* T, double* P, double* rho, double* a);
+
+/**
+ * @brief Параметры атмосферы для массива высот
+ * @details Состояние плотной таблицы читается один раз на весь массив,
+ * значения совпадают с поэлементными вызовами BCA.
+ * @param H - высоты над уровнем моря [м], n значений.
+ * @param n - количество высот.
+ * @param T, P, rho, a - массивы результатов по n значений, как в BCA.
+ */
+void BCA(const double* H, int n, double* T, double* P, double* rho, double* a);
+
+/**
+ * @brief Включить плотную таблицу BCA
+ * @details Таблица строится на равномерной сетке от минус 2000 м до Hmax.
+ * Вызывается до начала расчёта, пока BCA не используется другими потоками.
+ * Сетка строится по геопотенциальной высоте, интервалы с границами слоёв
+ * вычисляются по слоям. Погрешность определяется кривизной профиля давления
+ * и растёт как квадрат шага: при шаге 10 м до 150 км относительная
+ * погрешность не превышает 1e-6.
+ * @param step - шаг сетки [м], 0 - выключить таблицу.
+ * @param Hmax - верхняя граница таблицы [м].
+ * @return Максимальная относительная погрешность по T, P, rho, a,
+ * измеренная в четвертях интервалов сетки.
+ */
+double BCA_Dense(double step, double Hmax = 150000.);
+
 #endif /* _ATMOSPHERE_H */
@@ -0,0 +1,95 @@
+/**
+ * @file avdflux.h
+ * @brief Heat flux to the surface by the Avduevsky method over batches of points.
+ * @copyright MIT License
+ */
+
+#ifndef _AVDFLUX_H_
+#define _AVDFLUX_H_
+
+#include <common.h>
+
+typedef struct {
+	double I0, IW, IE, ISTAR, ALC, ALC1, QCONV, XAP1, P0, P1, V0, F1, F2, F3, KDIS, KENTH;
+} avd_t;
+
+/**
+ * @brief Batch of points of the heat-flux kernel, structure of arrays.
+ * @details Every array has count values, one per point (lane). The inputs
+ * are set by avd_set(), the outputs are the fields of avd_t filled by
+ * avd_flux(). Neighbouring lanes with the same free stream (TB, ROH, V, M)
+ * share the free stream part of the computation.
+ */
+typedef struct {
+	/** Number of points. */
+	int count;
+	/** Free stream temperature, K. */
+	vector<double> TB;
+	/** Free stream density. */
+	vector<double> ROH;
+	/** Velocity, m/s. */
+	vector<double> V;
+	/** Mach number. */
+	vector<double> M;
+	/** Pressure coefficient P/P0. */
+	vector<double> P;
+	/** Wall temperature, K. */
+	vector<double> TW;
+	/** Axis coordinate of the point, m. */
+	vector<double> X;
+	/** Surface inclination angle, deg. */
+	vector<double> O;
+	/** Nose radius, m. */
+	vector<double> Rad;
+	/** Effective length. */
+	vector<double> XEF;
+	/** Recession parameter of the previous step. */
+	vector<double> GK;
+	/** Laminar boundary layer (0 - turbulent). */
+	vector<int> LT;
+	/** Ablation type of the surface material. */
+	vector<int> ICC;
+	/** Results, the fields of avd_t. */
+	vector<double> I0, IW, IE, ISTAR, ALC, ALC1, QCONV, XAP1, P0, P1, V0, F1, F2, F3, KDIS, KENTH;
+} avd_batch_t;
+
+/**
+ * @brief Set number of points of the batch.
+ * @param batch - batch of points.
+ * @param count - number of points.
+ */
+void avd_resize(avd_batch_t* batch, int count);
+
+/**
+ * @brief Set inputs of the point k.
+ * @param batch - batch of points.
+ * @param k - point number.
+ */
+void avd_set(avd_batch_t* batch, int k, double TB, double ROH, double V, double M, double P, double TW,
+	double X, double O, double Rad, double XEF, int LT, int ICC, double GK);
+
+/**
+ * @brief Compute heat flux at all points of the batch.
+ * @param batch - batch of points.
+ */
+void avd_flux(avd_batch_t* batch);
+
+/**
+ * @brief Return results of the point k.
+ * @param batch - batch of points.
+ * @param k - point number.
+ */
+avd_t avd_get(const avd_batch_t& batch, int k);
+
+/**
+ * @brief Recompute the blowing correction of a computed point.
+ * @details Sets ALC1 and QCONV from ALC, IE and IW as avd_flux() does, so a
+ * point computed for one recession parameter can be reused for another.
+ * @param avd - results of the point.
+ * @param ICC - ablation type of the surface material.
+ * @param TW - wall temperature, K.
+ * @param GK - recession parameter.
+ */
+void avd_blowing(avd_t* avd, int ICC, double TW, double GK);
+
+#endif /* _AVDFLUX_H_ */
@@ -0,0 +1,86 @@
+/**
+ * @file avdrun.h
+ * @brief Настройки решателей из командной строки и таблица результатов, общие для режимов расчёта.
+ * @copyright MIT License
+ */
+
+#ifndef _AVDRUN_H_
+#define _AVDRUN_H_
+
+#include <common.h>
+#include <avdtparser.h>
+#include <avdsolver.h>
+#include <adisolver.h>
+#include <resfile.h>
+
+/** Настройки решателя, заданные в командной строке. */
+typedef struct {
+	/** Схема интегрирования по времени. */
+	int SCHEME;
+	/** Допустимая локальная погрешность температуры, К. */
+	double TOL;
+	/** Максимальный шаг счёта (0 - по умолчанию), с. */
+	double TIMESTEP_MAX;
+	/** Точность итераций Пикара (0 - без итераций), К. */
+	double PICARD_TOL;
+	/** Перепад температуры для измельчения сетки (0 - без перестройки), К. */
+	double REMESH_DT;
+	/** Унос на подвижной сетке. */
+	bool MOVING;
+	/** Кванты времени (0 - без кэша), с, и температуры поверхности, К, кэша газодинамики. */
+	double MEMO_DT, MEMO_DTW;
+	/** Источник теплового потока. */
+	const CHeatFlux* FLUX;
+	/** Имена параметров ГУ на поверхности, изменяемых во времени. */
+	vector<const char*> BC_NAMES;
+	/** Таблицы множителей параметров ГУ по времени. */
+	vector<func_points_t> BC_COEFS;
+} options_t;
+
+/**
+ * @brief Применить настройки командной строки к решателю.
+ * @param solver - решатель.
+ * @param thm - тепловая модель решателя.
+ * @param opt - настройки.
+ * @param prn - параметры печати.
+ * @return SUCCESS или NULL_VALUE, если настройки не подходят к модели (сообщение выводится).
+ */
+int configure(AVDSolver* solver, thm_t* thm, const options_t& opt, const print_t& prn);
+
+/**
+ * @brief Вывести заголовок таблицы результатов.
+ * @details Тот же заголовок выводит res_convert() для двоичного файла результатов.
+ * @param f - файл результатов.
+ * @param columns - столбцы result_columns().
+ */
+void print_header(FILE* f, const vector<res_column_t>& columns);
+
+/**
+ * @brief Столбцы таблицы результатов.
+ * @details Заголовок столбца ячейки содержит её начальную температуру,
+ * столбца температуры стенки двумерной задачи - координату сечения.
+ * @param thm - тепловая модель выводимой точки.
+ * @param prn - параметры печати.
+ * @param adi - двумерный решатель (0 - одномерная задача).
+ */
+vector<res_column_t> result_columns(thm_t* thm, const print_t& prn, CADISolver* adi);
+
+/**
+ * @brief Значения строки таблицы результатов.
+ * @param row - значения столбцов result_columns() (выход).
+ * @param info - результаты шага печати.
+ * @param thm - тепловая модель выводимой точки.
+ * @param prn - параметры печати.
+ * @param adi - двумерный решатель (0 - одномерная задача).
+ */
+void result_row(double* row, const avdsolver_t& info, thm_t* thm, const print_t& prn, CADISolver* adi);
+
+/**
+ * @brief Вывести строку таблицы результатов.
+ * @param f - файл результатов.
+ * @param columns - столбцы таблицы.
+ * @param row - значения столбцов.
+ */
+void print_row(FILE* f, const vector<res_column_t>& columns, const double* row);
+
+#endif /* _AVDRUN_H_ */
@@ -12,11 +12,12 @@
 #include <thsolver.h> //  
 #include <model.h> //  
 #include <bluntedcone.h>
+#include <boundary.h> //  
+#include <avdflux.h> //     
+#include <heatflux.h> //   
 
-
-typedef struct {
-	double I0, IW, IE, ISTAR, ALC, ALC1, QCONV, XAP1, P0, P1, V0, F1, F2, F3, KDIS, KENTH;
-} avd_t;
+/**    :   A    . */
+#define ZERO_ABLATION_A	(-3)
 
 /**    . */
 typedef struct {
@@ -51,7 +52,96 @@ typedef struct {
 	double G;
 	/**   . */
 	solve_result_t srt;
+	/**       Solve(). */
+	int PICARD_ITERS;
+	/**        . */
+	int PICARD_MAX;
+	/**  Solve(): SUCCESS    ,    . */
+	int STATUS;
 } avdsolver_t;
+/**      ,     . */
+typedef struct {
+	/**  , . */
+	double time;
+	/** ,  */
+	double H;
+	/** , /*/
+	double V;
+	/**  , . */
+	double al;
+	/**     , . */
+	double PHI;
+	/**  , . */
+	double TB;
+	/**  . */
+	double PH;
+	/**  . */
+	double ROH;
+	/**  , /. */
+	double D;
+	/**   */
+	double mach;
+} flow_t;
+/**
+ * @brief     .
+ * @details         
+ *      .   
+ *     , , ,  
+ *     ,    .   
+ * (ALC1  QCONV)       
+ *  G,       .
+ */
+typedef struct {
+	/**  ,  (0 -  ). */
+	double DT;
+	/**   , . */
+	double DTW;
+	/**       . */
+	long TKEY, WKEY;
+	/**   . */
+	bool VALID;
+	/**      . */
+	avdsolver_t info;
+	/**  ,   . */
+	long HITS;
+	/**    . */
+	long CALLS;
+} memo_t;
+/**
+ * @brief       .
+ * @details  (AT = 1)   G1,  (AT = 0)
+ *    .      .
+ */
+class CAVDRecession : public CRecession {
+public:
+	/**  . */
+	CMaterial* M;
+	/**    . */
+	double AT;
+	/**   . */
+	double A, B;
+	/**    . */
+	avd_t avd;
+	/**
+	 * @brief   .
+	 * @param Tw -  , .
+	 */
+	double G(double Tw);
+	/**
+	 * @brief  ,    (AT = 1).
+	 * @param Tw -  , .
+	 */
+	double G1(double Tw);
+	/**
+	 * @brief   , /.
+	 * @details   (AT = 1)     G1,
+	 *   ,   , 
+	 *         .
+	 * @param Tw -  , .
+	 */
+	virtual double velocity(double Tw);
+};
+
 /**      ,      . */
 class AVDSolver {
 	/**       . */
@@ -64,6 +154,38 @@ class AVDSolver {
 	CTHSolver* thsolver;
 	/**  . */
 	double TIMESTEP;
+	/**   . */
+	double TIMESTEP_MAX;
+	/**    : SCHEME_EULER  SCHEME_TRBDF2. */
+	int SCHEME;
+	/**     (DT_REFINE = 0 -   ). */
+	remesh_t REMESH;
+	/**    , . */
+	double REMESH_TIME;
+	/**        . */
+	bool MOVING;
+	/**     . */
+	CAVDRecession recession;
+	/**         ( Setup()  Complete()). */
+	double AT, A, B;
+	/**     ,   . */
+	CBoundary* LBC;
+	/**       . */
+	bool isMoving;
+
+	/**     . */
+	int CURSOR;
+	/**    (0 -   ). */
+	const CHeatFlux* FLUX;
+	/**      . */
+	int FLUX_CURSOR;
+	/**        Solve(). */
+	avd_batch_t lane;
+	/**   . */
+	memo_t MEMO;
+	/**    ,       . */
+	CFOBoundary FO;
+	CSOBoundary SO;
 
 	CBluntedCone* BCone;
 public:
@@ -72,8 +194,153 @@ public:
 	/**
 	 * @brief  .
 	 * @param time -  ,     .
+	 * @return  .    ,  
+	 *  ,       STATUS.
 	 */
 	avdsolver_t Solve(double time);
+	/**
+	 * @brief        .
+	 * @param trm - .
+	 * @param time -  , .
+	 * @param flow - ,    .
+	 * @param cursor -      (  0)  0.
+	 *           O(1).
+	 */
+	static void Flow(trm_t* trm, double time, flow_t* flow, int* cursor = 0);
+	/**
+	 * @brief        Advance().
+	 */
+	static void Reset(avdsolver_t* info);
+	/**
+	 * @brief   :        .
+	 * @details    timestep()       
+	 * Prepare(), avd_flux()  Advance().    
+	 *      ,     
+	 *        avd_flux()  .
+	 * @param flow -      .
+	 * @param info -   .
+	 * @param batch -    .
+	 * @param k -    .
+	 */
+	void Prepare(const flow_t& flow, avdsolver_t* info, avd_batch_t* batch, int k);
+	/**
+	 * @brief        info->avd.
+	 * @details   timestep()    .
+	 * @param info -     Prepare(),  (G    ).
+	 * @return SUCCESS    Setup(),    .
+	 */
+	int Advance(avdsolver_t* info);
+	/**
+	 * @brief   Advance():        .
+	 * @details  Advance()   Setup(),     
+	 * CURRENT_TIME+timestep()  Complete().    
+	 *      (CTHSolverPack).
+	 * @param info -     Prepare().
+	 * @return SUCCESS    (ZERO_ABLATION_A),    .
+	 */
+	int Setup(avdsolver_t* info);
+	/**
+	 * @brief   Advance(): ,     .
+	 * @param info -   , .
+	 * @param srt -      .
+	 */
+	void Complete(avdsolver_t* info, const solve_result_t& srt);
+	/**
+	 * @brief          .
+	 * @details       , 
+	 *     Remember().
+	 * @param info -   .
+	 * @return true,     .
+	 */
+	bool Recall(avdsolver_t* info);
+	/**
+	 * @brief         .
+	 * @param info -     Prepare()  avd_flux().
+	 */
+	void Remember(const avdsolver_t& info);
+	/**
+	 * @brief         .
+	 * @details  ,   ,    
+	 *     (. CBoundary::SetTimeChangeCoefs()).
+	 * @param pname -  : "acp", "Ie", "Iw", "I0", "eps", "P"  "Tw".
+	 * @param table -    .
+	 * @return  CBoundary::SetTimeChangeCoefs().
+	 */
+	int setTimeChangeCoefs(const char* pname, const func_points_t* table);
+	/**
+	 * @brief    .
+	 * @details          
+	 *  .
+	 * @param FLUX -    (0 -   ).
+	 */
+	void setHeatFlux(const CHeatFlux* FLUX);
+	/**
+	 * @brief    .
+	 * @details     ,   
+	 *  DT  DTW.  example.tr  DT=0.1 , DTW=2   
+	 *          1  ( memo 
+	 * utils/avdtest).
+	 * @param DT -  ,  (0 - ).
+	 * @param DTW -   , .
+	 */
+	void setMemo(double DT, double DTW);
+	/**    . */
+	const memo_t& memo();
+	/**
+	 * @brief          .
+	 * @details    Solve().
+	 * @param f -   .
+	 */
+	void save(FILE* f) const;
+	/**
+	 * @brief         .
+	 * @details        ,   .
+	 * @param f -   .
+	 * @return SUCCESS  NULL_VALUE,        .
+	 */
+	int load(FILE* f);
+	/**  ()  , . */
+	double timestep();
+	/**
+	 * @brief       Advance().
+	 * @param TIMESTEP -  , .
+	 */
+	void setTimestep(double TIMESTEP);
+	/**   . */
+	thm_t* model();
+	/**  . */
+	CTHSolver* thermal();
+	/**
+	 * @brief     .
+	 * @details  SCHEME_TRBDF2       
+	 *       / .
+	 * @param SCHEME - SCHEME_EULER  SCHEME_TRBDF2.
+	 * @param TOL -    , .
+	 * @param TIMESTEP_MAX -   , .
+	 */
+	void setScheme(int SCHEME, double TOL, double TIMESTEP_MAX);
+	/**
+	 * @brief        .
+	 * @param ITERS_MAX -    (0 - ).
+	 * @param TOL -     , .
+	 */
+	void setPicard(int ITERS_MAX, double TOL);
+	/**
+	 * @brief    .
+	 * @details     ,    
+	 *    prefs.PERIOD.
+	 * @param prefs -   .
+	 */
+	void setRemesh(const remesh_t& prefs);
+	/**
+	 * @brief     .
+	 * @details         
+	 *  (),     
+	 *    .      10% 
+	 *  ,      .
+	 * @param MOVING -   .
+	 */
+	void setMoving(bool MOVING);
 	/**  . */
 	~AVDSolver();
 	/**   . */
@@ -11,6 +11,7 @@
 #include <common.h>
 #include <bluntedcone.h>
 #include <model.h>
+#include <interp.h>
 
 /** Структура для хранения параметров вывода на экран. */
 typedef struct {
@@ -19,7 +20,7 @@ typedef struct {
 	/** Шаг печати, с. */
 	double print_interval;
 	/** Номера ячеек, выводимых на печать. */
-	int PRINT_CELLS[CELLS_MAX_NUM];
+	int *PRINT_CELLS;
 } print_t;
 /**
  * @brief Описание траектории движения ЛА.
@@ -34,13 +35,13 @@ typedef struct {
 	/** Угол входа в атмосферу на высоте 100 км. */
 	double THETA;
 	/** Массив опорных скоростей, м/с. */
-	IFunc V;
+	CInterp<1> V;
 	/** Массив опорных высот, м. */
-	IFunc H;
+	CInterp<1> H;
 	/** Массив опорных углов атаки, в градусах. */
-	IFunc AL;
+	CInterp<1> AL;
 	/** Массив опорных углов поворота вокруг оси, в градусах. */
-	IFunc PHI;
+	CInterp<1> PHI;
 } trm_t;
 /** Структура для хранения газодинамических параметров обтекающего тело потока. */
 typedef struct {
@@ -51,11 +52,11 @@ typedef struct {
 	/** Высота ламинарно-турбулентного перехода в точке Х, м. */
 	double HT;
 	/** Массив коэффициентов давления, P/P0. */
-	ICube PP0;
+	CInterp<3> PP0;
 	/** Массив турбулентных эффективных длин, Xefft^0.2 */
-	ICube XET;
+	CInterp<3> XET;
 	/** Массив ламинарных эффективных длин, Xeffl^0.5 */
-	ICube XEL;
+	CInterp<3> XEL;
 } gasdynamics_t;
 /**
  * @brief Выполнить чтение из файла ИД
@@ -13,6 +13,10 @@
 #include <common.h>
 #include <math_addons.h>
 #include <model.h>
+
+/** Number of boundary parameters which can be changed in time: acp, Ie, Iw, I0, eps, Tw, P. */
+#define BC_PARAMS	(7)
+
 /**
  * @brief Структура данных, возвращаемых классом ГУ.
  */
@@ -38,9 +42,29 @@ typedef struct {
  */
 class CBoundary {
 	int Type;
+	/* Boundary owns its multiplier tables and can't be copied by value. */
+	CBoundary(const CBoundary&);
+	CBoundary& operator=(const CBoundary&);
 protected:
 	/** Base parameters of second-order boundary condition */
 	BC_t BC;
+	/** Time multipliers of the parameters in order of BC_PARAMS (count = 0 - no multiplier). */
+	func_points_t COEF[BC_PARAMS];
+	/** Number of multiplier tables set. */
+	int COEFS;
+	/**
+	 * @brief Set multiplier table of the parameter.
+	 * @param pname - boundary parameter name.
+	 * @param table - interpolation table of the multiplier by time.
+	 * @param mask - bits of parameters (in order of BC_PARAMS) valid for the boundary.
+	 * @return Opcode as SetTimeChangeCoefs().
+	 */
+	int setCoefs(const char* pname, const func_points_t* table, unsigned mask);
+	/**
+	 * @brief Base parameters multiplied by the time multipliers.
+	 * @param Time - current time, s.
+	 */
+	BC_t scaled(double Time);
 public:
 	/** Output device for logging */
 	FILE* flog;
@@ -53,6 +77,8 @@ public:
 	 * @param boundary - pointer to the class, which will be assigned to the new class.
 	 */
 	CBoundary(CBoundary *boundary);
+	/** Class destructor. */
+	virtual ~CBoundary();
 	/** Returns class type. */
 	int type();
 	/** Calculate boundary parameters.
@@ -63,7 +89,9 @@ public:
 	 * @brief Set time-dependent boundary parameter changes by multipliers.
 	 * @param pname - boundary parameter name
 	 * @param table - pointer to interpolation table for multiplier
-	 * @return Opcode. NULL_VALUE - interpolation table can't be used. -2 - pname is not valid
+	 * @details The table is copied. The parameter is multiplied by the value
+	 * interpolated at the time of GetBC(). A parameter set again replaces its table.
+	 * @return Opcode. SUCCESS, NULL_VALUE - interpolation table can't be used. -2 - pname is not valid
 	 */
 	virtual int SetTimeChangeCoefs(const char* pname, const func_points_t* table) = 0;
 	/**
@@ -82,6 +110,11 @@ public:
 	 * @param flog - output device for logging
 	 */
 	CFOBoundary(double Tw, FILE* flog=stdout);
+	/**
+	 * @brief Update base parameters in place.
+	 * @param Tw - wall temperature.
+	 */
+	void set(double Tw);
 	/**
 	 * @brief Выдать параметры граничного условия.
 	 * param Time - текущий момент расчётного времени.
@@ -89,9 +122,9 @@ public:
 	virtual BC_t GetBC(double Time);
 	/**
 	 * @brief Set time-dependent boundary parameter changes by multipliers.
-	 * @param pname - boundary parameter name
+	 * @param pname - boundary parameter name: "Tw"
 	 * @param table - pointer to interpolation table for multiplier
-	 * @return Opcode. NULL_VALUE - interpolation table can't be used. -2 - pname is not valid
+	 * @return Opcode. SUCCESS, NULL_VALUE - interpolation table can't be used. -2 - pname is not valid
 	*/
 	virtual int SetTimeChangeCoefs(const char* pname, const func_points_t* table);
 	/** Распечатать внутренние данные класса. */
@@ -109,6 +142,10 @@ public:
 	 * @param flog - output device for logging
 	 */
 	CSOBoundary(double acp, double I0, double Ie, double Iw, double Ps, double eps = 0., FILE* flog = stdout);
+	/**
+	 * @brief Update base parameters in place, as in the constructor.
+	 */
+	void set(double acp, double I0, double Ie, double Iw, double Ps, double eps = 0.);
 	/**
 	 * @brief Выдать параметры граничного условия.
 	 * param Time - текущий момент расчётного времени.
@@ -116,9 +153,9 @@ public:
 	virtual BC_t GetBC(double Time);
 	/**
 	 * @brief Set time-dependent boundary parameter changes by multipliers.
-	 * @param pname - boundary parameter name
+	 * @param pname - boundary parameter name: "acp", "Ie", "Iw", "I0", "eps", "P"
 	 * @param table - pointer to interpolation table for multiplier
-	 * @return Opcode. NULL_VALUE - interpolation table can't be used. -2 - pname is not valid
+	 * @return Opcode. SUCCESS, NULL_VALUE - interpolation table can't be used. -2 - pname is not valid
 	*/
 	virtual int SetTimeChangeCoefs(const char* pname, const func_points_t* table);
 	/** Распечатать внутренние данные класса. */
@@ -0,0 +1,87 @@
+/**
+ * @file checkpoint.h
+ * @brief Binary checkpoint of the single point solution.
+ * @details The checkpoint keeps the state of the thermal model, of the
+ * solvers and of the main loop, so the solution resumed from it is
+ * bit-identical to the uninterrupted one. The file is raw binary of the
+ * build that wrote it; it is read back with the same input files and
+ * solver options.
+ * @copyright MIT License
+ */
+
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include <common.h>
+
+/** Signature and version of the checkpoint file. */
+#define CKPT_MAGIC		"AVDCKPT3"
+
+class AVDSolver;
+
+/** State of the main loop saved with the solver. */
+typedef struct {
+	/** Names of the trajectory and TPS files. */
+	char TR[FILENAME_MAX_LEN], TPS[FILENAME_MAX_LEN];
+	/** Time of the last printed results, s. */
+	double time;
+	/** Total and maximum numbers of the Picard iterations. */
+	int PICARD_ITERS, PICARD_MAX;
+	/** Length of the results file at the checkpoint, bytes. */
+	long RES_SIZE;
+	/** Length of the binary results file at the checkpoint, bytes (-1 - the table is in the results file). */
+	long BRES_SIZE;
+} ckpt_t;
+
+/** Write n values to the checkpoint. */
+template <typename T> void ckpt_write(FILE* f, const T* v, size_t n = 1)
+{
+	fwrite(v, sizeof(T), n, f);
+}
+
+/** Read n values from the checkpoint. Returns false if the file is too short. */
+template <typename T> bool ckpt_read(FILE* f, T* v, size_t n = 1)
+{
+	return (fread(v, sizeof(T), n, f) == n);
+}
+
+/** Write a vector with its size to the checkpoint. */
+template <typename T> void ckpt_write(FILE* f, const vector<T>& v)
+{
+	size_t n = v.size();
+	ckpt_write(f, &n);
+	if (n > 0)
+		ckpt_write(f, &(v[0]), n);
+}
+
+/** Read a vector with its size from the checkpoint. */
+template <typename T> bool ckpt_read(FILE* f, vector<T>* v)
+{
+	size_t n;
+	if (!ckpt_read(f, &n))
+		return false;
+	v->resize(n);
+	return (n == 0) || ckpt_read(f, &((*v)[0]), n);
+}
+
+/**
+ * @brief Save a checkpoint.
+ * @details The file is written under a temporary name and renamed, so an
+ * interrupted save keeps the previous checkpoint.
+ * @param filename - checkpoint file.
+ * @param ckpt - state of the main loop.
+ * @param solver - solver of the point.
+ * @return SUCCESS or NULL_VALUE if the file can't be written.
+ */
+int checkpoint_save(const char* filename, const ckpt_t& ckpt, const AVDSolver& solver);
+
+/**
+ * @brief Load a checkpoint.
+ * @param filename - checkpoint file.
+ * @param ckpt - state of the main loop (output).
+ * @param solver - solver of the point, configured as at the save.
+ * @return SUCCESS or NULL_VALUE if the file can't be read or doesn't fit the model.
+ */
+int checkpoint_load(const char* filename, ckpt_t* ckpt, AVDSolver* solver);
+
+#endif /* _CHECKPOINT_H_ */
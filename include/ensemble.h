@@ -0,0 +1,26 @@
+/**
+ * @file ensemble.h
+ * @brief Расчёт ансамбля вариантов "траектория x ТЗП x точка поверхности".
+ * @copyright MIT License
+ */
+
+#ifndef _ENSEMBLE_H_
+#define _ENSEMBLE_H_
+
+#include <avdrun.h>
+
+/**
+ * @brief Расчёт ансамбля вариантов по списку.
+ * @details Строка списка: "ТРАЕКТОРИЯ ТЗП [X [PHI]]", X и PHI заменяют координату
+ * и угол точки из файла ТЗП, '#' начинает комментарий. Каждый файл ИД разбирается
+ * один раз, протокол разбора выводится в файл <список>.log, результаты варианта n
+ * (по порядку в списке) - в файл <траектория>-<ТЗП>-<n>.res. Вариант, который
+ * невозможно рассчитать, отмечается в выводе, остальные рассчитываются до конца.
+ * @param manifest - файл списка вариантов.
+ * @param opt - настройки решателей.
+ * @param BINARY - таблицы результатов выводятся в двоичные файлы <траектория>-<ТЗП>-<n>.bres.
+ * @return Количество вариантов, расчёт которых не удался.
+ */
+int ensemble(const char* manifest, const options_t& opt, bool BINARY);
+
+#endif /* _ENSEMBLE_H_ */
@@ -0,0 +1,98 @@
+/**
+ * @file heatflux.h
+ * @brief Sources of the convective heat flux to the surface.
+ * @copyright MIT License
+ */
+
+#ifndef _HEATFLUX_H_
+#define _HEATFLUX_H_
+
+#include <common.h>
+#include <avdflux.h>
+#include <interp.h>
+
+/**
+ * @brief Source of the convective heat flux at the surface.
+ * @details A source is loaded once before the march and then only read, so
+ * one source can be shared by the solvers of all threads. apply() is
+ * called on every step after the Avduevsky kernel and may replace its
+ * results. It does no file I/O and no allocations. A source keeps no state
+ * between calls: each solver keeps its own cursor in the tables of the
+ * source, so a march in time locates the time in amortized O(1).
+ */
+class CHeatFlux {
+public:
+	virtual ~CHeatFlux() {}
+	/**
+	 * @brief Set the heat flux of the step.
+	 * @param time - current time, s.
+	 * @param avd - results of the Avduevsky kernel for the step (input and output).
+	 * @param cursor - cursor of the caller in the tables of the source (may be 0),
+	 * 0 before the first call.
+	 */
+	virtual void apply(double time, avd_t* avd, int* cursor) const = 0;
+};
+
+/** Heat flux by the Avduevsky correlation: the kernel results are kept. */
+class CAvdHeatFlux : public CHeatFlux {
+public:
+	virtual void apply(double time, avd_t* avd, int* cursor) const;
+};
+
+/**
+ * @brief Tabulated heat flux q(t).
+ * @details Text file of rows "time q", time in s, q in W/m^2, any number of
+ * rows in ascending time. Heat transfer coefficient follows from the
+ * enthalpies of the kernel.
+ */
+class CTableHeatFlux : public CHeatFlux {
+	/** Heat flux as a function of time. */
+	CInterp<1> Q;
+public:
+	/**
+	 * @brief Load the table.
+	 * @param filename - name of the file.
+	 */
+	CTableHeatFlux(const char* filename);
+	virtual void apply(double time, avd_t* avd, int* cursor) const;
+};
+
+/**
+ * @brief Heat flux replayed from the results of a previous run.
+ * @details Reads the RESULTS section of an avd .res file and replays its
+ * heat flux QCONV, surface pressure P, heat transfer coefficient ALC and
+ * recovery enthalpy IE by time. The wall enthalpy stays from the kernel.
+ */
+class CReplayHeatFlux : public CHeatFlux {
+	/** Replayed columns as functions of time. */
+	CInterp<1> QCONV, P1, ALC, IE;
+public:
+	/**
+	 * @brief Load the results.
+	 * @param filename - name of the .res file.
+	 */
+	CReplayHeatFlux(const char* filename);
+	virtual void apply(double time, avd_t* avd, int* cursor) const;
+};
+
+/**
+ * @brief Heat flux of another source multiplied by a constant factor.
+ * @details The heat transfer coefficient is scaled with the flux, the
+ * enthalpies are kept.
+ */
+class CScaledHeatFlux : public CHeatFlux {
+	/** Base source. */
+	const CHeatFlux* FLUX;
+	/** Factor of the heat flux. */
+	double K;
+public:
+	/**
+	 * @brief Class constructor.
+	 * @param flux - base source.
+	 * @param k - factor of the heat flux.
+	 */
+	CScaledHeatFlux(const CHeatFlux* flux, double k);
+	virtual void apply(double time, avd_t* avd, int* cursor) const;
+};
+
+#endif /* _HEATFLUX_H_ */
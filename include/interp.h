@@ -0,0 +1,283 @@
+/**
+ * @file interp.h
+ * @brief Tensor-product linear interpolation over flat tables.
+ * @copyright MIT License
+ */
+
+#ifndef _INTERP_H_
+#define _INTERP_H_
+
+#include <common.h>
+#include <arena.h>
+#include <cstring>
+#include <algorithm>
+
+/** Number of knots a cursor walks forward before falling back to binary search. */
+#define INTERP_CURSOR_WALK	(8)
+
+/**
+ * @brief Linear interpolation of a function of N arguments on a rectangular grid.
+ * @details Axes and values are stored in one aligned block. Values are
+ * ordered with the first argument changing fastest. Each axis is located by
+ * a direct index computation when its knots are uniform, by binary search
+ * otherwise. Arguments beyond an axis are clamped to its end knot. The
+ * interpolation is nested from the last argument to the first, with the
+ * same arithmetic as the former IFunc/ITable/ICube classes.
+ * Queries along a monotonic march (e.g. in time) can keep a cursor per axis:
+ * the search starts from the interval of the previous query and walks
+ * forward, moving backward falls back to binary search. Cursors belong to
+ * the caller, so one function can be shared between threads.
+ */
+template <int N> class CInterp {
+	/** Number of knots on each axis. */
+	int n[N];
+	/** Distance between neighbouring values along each axis. */
+	int stride[N];
+	/** Knots of the axes, ascending. */
+	double* axis[N];
+	/** Inverse step of the uniform axes, 0 for non-uniform ones. */
+	double inv[N];
+	/** Values of the function at the grid nodes. */
+	double* F;
+	/** Storage of the axes and values. */
+	CArena arena;
+	/**
+	 * Locate x on the axis d: knot i, offset dx from it and length h of the interval.
+	 * The cursor (may be 0) keeps the upper knot of the interval between queries.
+	 */
+	bool locate(int d, double x, int* i, double* dx, double* h, int* cursor) const
+	{
+		const double* a = axis[d];
+		const int last = n[d]-1;
+		if ((last == 0) || (x <= a[0])) {
+			*i = 0;
+			return true;
+		}
+		if (x >= a[last]) {
+			*i = last;
+			return true;
+		}
+		/* First knot k with a[k] >= x: x is in (a[k-1], a[k]]. */
+		int k;
+		if ((cursor != 0) && (*cursor >= 1) && (*cursor <= last)) {
+			k = *cursor;
+			if (a[k-1] < x) {
+				for (int walk=0; (walk < INTERP_CURSOR_WALK) && (a[k] < x); walk++)
+					k++;
+				if (a[k] < x)
+					k = (int)(lower_bound(a+k, a+last, x) - a);
+			} else
+				k = (int)(lower_bound(a+1, a+k, x) - a);
+		} else if (inv[d] > 0.) {
+			k = (int)ceil((x - a[0])*inv[d]);
+			k = (k < 1) ? 1 : ((k > last) ? last : k);
+			while (a[k-1] >= x)
+				k--;
+			while (a[k] < x)
+				k++;
+		} else
+			k = (int)(lower_bound(a+1, a+last, x) - a);
+		if (cursor != 0)
+			*cursor = k;
+		*i = k-1;
+		*dx = x - a[k-1];
+		*h = a[k] - a[k-1];
+		return false;
+	}
+	/** Interpolate along the axes 0...d from the node offset. */
+	double eval(int d, int offset, const int* i, const double* dx, const double* h, const bool* clamped) const
+	{
+		if (d < 0)
+			return F[offset];
+		double P1 = eval(d-1, offset+i[d]*stride[d], i, dx, h, clamped);
+		if (clamped[d])
+			return P1;
+		double P2 = eval(d-1, offset+(i[d]+1)*stride[d], i, dx, h, clamped);
+		return P1 + (P2-P1)*dx[d]/h[d];
+	}
+	/** Cut the axes and values from the arena. */
+	void allocate()
+	{
+		int nodes = 1;
+		size_t bytes = 0;
+		for (int d=0; d<N; d++) {
+			stride[d] = nodes;
+			nodes *= n[d];
+			bytes += CArena::align(n[d]*sizeof(double));
+		}
+		arena.reserve(bytes+CArena::align(nodes*sizeof(double)));
+		for (int d=0; d<N; d++)
+			axis[d] = arena.alloc<double>(n[d]);
+		F = arena.alloc<double>(nodes);
+	}
+public:
+	/** Class constructor. Creates empty function. */
+	CInterp()
+	{
+		for (int d=0; d<N; d++) {
+			n[d] = 0;
+			axis[d] = 0;
+		}
+		F = 0;
+	}
+	/** Copy constructor. */
+	CInterp(const CInterp& f)
+	{
+		F = 0;
+		*this = f;
+	}
+	/** Assignment. */
+	CInterp& operator=(const CInterp& f)
+	{
+		if (this == &f)
+			return *this;
+		if (f.F == 0) {
+			for (int d=0; d<N; d++) {
+				n[d] = 0;
+				axis[d] = 0;
+			}
+			F = 0;
+			return *this;
+		}
+		memcpy(n, f.n, sizeof(n));
+		memcpy(inv, f.inv, sizeof(inv));
+		allocate();
+		for (int d=0; d<N; d++)
+			memcpy(axis[d], f.axis[d], n[d]*sizeof(double));
+		memcpy(F, f.F, nodes()*sizeof(double));
+		return *this;
+	}
+	/**
+	 * @brief Create the grid. Values are set to zero.
+	 * @param count - number of knots on each axis.
+	 * @param axes - knots of each axis, ascending.
+	 */
+	void create(const int* count, const double* const* axes)
+	{
+		for (int d=0; d<N; d++) {
+			assert(count[d] > 0);
+			n[d] = count[d];
+		}
+		allocate();
+		for (int d=0; d<N; d++) {
+			memcpy(axis[d], axes[d], n[d]*sizeof(double));
+			const double range = axis[d][n[d]-1] - axis[d][0];
+			inv[d] = (range > 0.) ? (n[d]-1)/range : 0.;
+			for (int k=1; k<n[d]; k++) {
+				assert(axis[d][k] >= axis[d][k-1]);
+				if (fabs(axis[d][k] - (axis[d][0] + k*range/(n[d]-1))) > 1.0E-12*range)
+					inv[d] = 0.;
+			}
+		}
+		memset(F, 0, nodes()*sizeof(double));
+	}
+	/**
+	 * @brief Transform all values of the function: F = k*F+b.
+	 * @param k - factor.
+	 * @param b - offset.
+	 */
+	void scale(double k, double b)
+	{
+		for (int i=0; i<nodes(); i++)
+			F[i] = k*F[i]+b;
+	}
+	/** Return minimum value of the function at the grid nodes. */
+	double min() const
+	{
+		assert(F != 0);
+		double m = F[0];
+		for (int i=1; i<nodes(); i++)
+			m = (F[i] < m) ? F[i] : m;
+		return m;
+	}
+	/** Return number of grid nodes. */
+	int nodes() const
+	{
+		return (F == 0) ? 0 : stride[N-1]*n[N-1];
+	}
+	/** Return number of knots on the axis d. */
+	int size(int d) const
+	{
+		return n[d];
+	}
+	/**
+	 * @brief Set value at the grid node.
+	 * @param idx - knot numbers on each axis.
+	 * @param value - value of the function.
+	 */
+	void set(const int* idx, double value)
+	{
+		int offset = 0;
+		for (int d=0; d<N; d++) {
+			assert((idx[d] >= 0) && (idx[d] < n[d]));
+			offset += idx[d]*stride[d];
+		}
+		F[offset] = value;
+	}
+	/**
+	 * @brief Value of the function.
+	 * @param x - arguments, N values.
+	 */
+	double val(const double* x) const
+	{
+		return val(x, (int*)0);
+	}
+	/**
+	 * @brief Value of the function with search cursors.
+	 * @param x - arguments, N values.
+	 * @param cursor - cursors of the axes, N values (0 - new cursor), or 0.
+	 */
+	double val(const double* x, int* cursor) const
+	{
+		int i[N];
+		double dx[N], h[N];
+		bool clamped[N];
+		assert(F != 0);
+		for (int d=0; d<N; d++)
+			clamped[d] = locate(d, x[d], &(i[d]), &(dx[d]), &(h[d]), (cursor != 0) ? &(cursor[d]) : 0);
+		return eval(N-1, 0, i, dx, h, clamped);
+	}
+	/**
+	 * @brief Values of the function at many points.
+	 * @param x - arguments, N values for each point.
+	 * @param f - values of the function (output).
+	 * @param count - number of points.
+	 */
+	void val(const double* x, double* f, int count) const
+	{
+		for (int k=0; k<count; k++)
+			f[k] = val(&(x[k*N]));
+	}
+	/** Value of the function of one argument. */
+	double val(double x) const
+	{
+		assert(N == 1);
+		return val(&x);
+	}
+	/**
+	 * @brief Value of the function of one argument with a search cursor.
+	 * @param x - argument.
+	 * @param cursor - cursor of the axis (0 - new cursor).
+	 */
+	double val(double x, int* cursor) const
+	{
+		assert(N == 1);
+		return val(&x, cursor);
+	}
+	/** Value of the function of two arguments. */
+	double val(double x, double y) const
+	{
+		assert(N == 2);
+		const double a[2] = {x, y};
+		return val(a);
+	}
+	/** Value of the function of three arguments. */
+	double val(double x, double y, double z) const
+	{
+		assert(N == 3);
+		const double a[3] = {x, y, z};
+		return val(a);
+	}
+};
+
+#endif /* _INTERP_H_ */
@@ -24,6 +24,8 @@ public:
 	 * @param flog - pointer to the output device.
 	 */
 	CMaterial(const char* title, FILE* flog);
+	/** Class destructor. */
+	virtual ~CMaterial() {}
 	/** Return short material name. */
 	char* name();
 	/** Heat Conductivity.
@@ -56,6 +58,21 @@ public:
 	 * @param T - current temperature.
 	 */
 	virtual double heatQuantity(double T) = 0;
+	/** Heat conductivity, density and specific heat of a run of cells.
+	 * @param T - temperatures of the cells.
+	 * @param l - heat conductivities (output).
+	 * @param c - specific heats (output).
+	 * @param r - densities (output).
+	 * @param n - number of cells.
+	 */
+	virtual void props(const double* T, double* l, double* c, double* r, int n);
+	/** Heat quantity of a run of cells.
+	 * @param T - temperatures of the cells.
+	 * @param w - widths of the cells.
+	 * @param n - number of cells.
+	 * @return Sum of w[i]*heatQuantity(T[i]), [J*m^-2].
+	 */
+	virtual double heatQuantity(const double* T, const double* w, int n);
 	/** Print material info.
 	 * @param pointer to the output device.
 	 */
@@ -118,6 +135,21 @@ public:
 	 * @return Heat Quantity, [J*m^-3]
 	 */
 	virtual double heatQuantity(double T);
+	/** Heat conductivity, density and specific heat of a run of cells.
+	 * @param T - temperatures of the cells.
+	 * @param l - heat conductivities (output).
+	 * @param c - specific heats (output).
+	 * @param r - densities (output).
+	 * @param n - number of cells.
+	 */
+	virtual void props(const double* T, double* l, double* c, double* r, int n);
+	/** Heat quantity of a run of cells.
+	 * @param T - temperatures of the cells.
+	 * @param w - widths of the cells.
+	 * @param n - number of cells.
+	 * @return Sum of w[i]*heatQuantity(T[i]), [J*m^-2].
+	 */
+	virtual double heatQuantity(const double* T, const double* w, int n);
 	/**
 	 * @brief Check correctess of material thermophysics
 	 * SUCCESS - if all defined correctly; NULL_VALUE, overwise
@@ -143,6 +175,19 @@ class CUserMaterial : public ConstMaterial {
 	func_points_t fA;
 	/** Ablation B-coefficient interpolation function. */
 	func_points_t fB;
+	/** Heat conductivity on the uniform temperature grid. */
+	utable_t uL;
+	/** Density on the uniform temperature grid. */
+	utable_t uRHO;
+	/** Specific heat on the uniform temperature grid. */
+	utable_t uCP;
+	/** Integral of the specific heat from T=0. */
+	qtable_t hCP;
+	/** Emissivity on the uniform temperature grid. */
+	utable_t uEPS;
+	/* Material owns its tables and can't be copied. */
+	CUserMaterial(const CUserMaterial&);
+	CUserMaterial& operator=(const CUserMaterial&);
 public:
 	/** Class constructor
 	 * @param title - material short name
@@ -158,8 +203,11 @@ public:
 	 */
 	CUserMaterial(const char* title, FILE* flog, double L, double RHO, double CP, double EPS,
 			double Tdestr, double A, double B, int Type);
+	/** Class destructor. */
+	virtual ~CUserMaterial();
 	/**
-	 * Set interpolation function to the property
+	 * Set interpolation function to the property.
+	 * The table is resampled to the uniform temperature grid with UTABLE_TOL accuracy.
 	 * @param prm - material property
 	 * @param table - interpolation fuction for the property
 	 */
@@ -196,6 +244,21 @@ public:
 	 * @return Heat Quantity, [J*m^-3]
 	 */
 	virtual double heatQuantity(double T);
+	/** Heat conductivity, density and specific heat of a run of cells.
+	 * @param T - temperatures of the cells.
+	 * @param l - heat conductivities (output).
+	 * @param c - specific heats (output).
+	 * @param r - densities (output).
+	 * @param n - number of cells.
+	 */
+	virtual void props(const double* T, double* l, double* c, double* r, int n);
+	/** Heat quantity of a run of cells.
+	 * @param T - temperatures of the cells.
+	 * @param w - widths of the cells.
+	 * @param n - number of cells.
+	 * @return Sum of w[i]*heatQuantity(T[i]), [J*m^-2].
+	 */
+	virtual double heatQuantity(const double* T, const double* w, int n);
 	/**
 	 * @brief Check correctess of material thermophysics
 	 * SUCCESS - if all defined correctly; NULL_VALUE, overwise
@@ -206,4 +269,38 @@ public:
 	 */
 	virtual void print(FILE *out = stdout);
 };
+/**
+ * @brief Material with the properties of another material multiplied by constant factors.
+ * @details Used to perturb the properties of a shared material in one model
+ * only: the base material is not changed.
+ */
+class CScaledMaterial : public CMaterial {
+	/** Base material. */
+	CMaterial* M;
+	/** Factors of the heat conductivity, specific heat, density, emissivity and ablation coefficients. */
+	double KL, KCP, KRHO, KEPS, KA, KB;
+public:
+	/** Class constructor
+	 * @param M - base material
+	 * @param KL - factor of the heat conductivity
+	 * @param KCP - factor of the specific heat
+	 * @param KRHO - factor of the density
+	 * @param KEPS - factor of the emissivity
+	 * @param KA - factor of the ablation A-coefficient
+	 * @param KB - factor of the ablation B-coefficient
+	 */
+	CScaledMaterial(CMaterial* M, double KL, double KCP, double KRHO, double KEPS, double KA, double KB);
+	virtual double l(double T);
+	virtual double c(double T);
+	virtual double r(double T);
+	virtual double eps(double T);
+	virtual double a(double T);
+	virtual double b(double T);
+	virtual double Td(double T);
+	virtual int at(void);
+	virtual double heatQuantity(double T);
+	virtual void props(const double* T, double* l, double* c, double* r, int n);
+	virtual double heatQuantity(const double* T, const double* w, int n);
+	virtual void print(FILE *out = stdout);
+};
 #endif /* _MATERIAL_H_ */
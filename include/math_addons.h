@@ -110,90 +110,108 @@ extern double in_LinearFunc(const func_points_t* points, double x, int method =
  */
 extern double ma_integral(const func_points_t* points, const double x);
 
-#include <vector>
-using namespace std;
+/** Допустимая относительная погрешность равномерной таблицы интерполяции. */
+#define UTABLE_TOL		(1.0E-6)
+/** Максимальное количество интервалов равномерной таблицы интерполяции. */
+#define UTABLE_MAX_CELLS	(4096)
 
+/**
+ * @brief Таблица интерполяции на равномерной сетке аргумента.
+ * @details На каждом интервале i функция задана прямой y = ab[2i] + ab[2i+1]*x,
+ * поэтому вычисление значения - одно вычисление индекса и одно умножение-сложение.
+ */
 typedef struct {
-	double valF;
-	double valX;
-} func_t;
-/** Класс предоставляет инструменты управления функцией интерполяции */
-class IFunc {
-	/** Cтруктура для хранения значений функции */
-	vector<func_t *> func1D;
-public:
-	/** Конструктор класса. */
-	IFunc();
-	/**
-	 * @brief Добавить точку интерполяции для функции
-	 * @param valX - значение аргумента.
-	 * @param valF - значение функции
-	 */
-	void add(double valX, double valF);
-	/** Выдать значение функции интерполяции
-	 * @param x - значение аргумента функции интерполяции.
-	 */
-	double val(double x);
-	/** Деструктор класса. */
-	void print();
-	~IFunc();
-};
+	/** Границы диапазона аргумента. */
+	double xmin, xmax;
+	/** Величина, обратная шагу сетки. */
+	double inv;
+	/** Коэффициенты прямых на интервалах (по два на интервал). */
+	double *ab;
+	/** Количество интервалов. */
+	int count;
+} utable_t;
 
+/**
+ * @brief Построить равномерную таблицу по таблице интерполяции.
+ * @details Шаг сетки равен наибольшему общему делителю расстояний между узлами
+ * (тогда таблица совпадает с линейной интерполяцией точно), иначе шаг уменьшается
+ * до тех пор, пока отклонение от линейной интерполяции in_LinearFunc() не станет
+ * меньше tol от максимального по модулю значения функции, но не более
+ * UTABLE_MAX_CELLS интервалов.
+ * @param points - таблица интерполяции, точки отсортированы по возрастанию аргумента.
+ * @param table - строимая таблица. Память выделяется функцией: table->ab равно 0
+ * или указывает на коэффициенты ранее построенной таблицы, которые переиспользуются.
+ * @param tol - допустимая относительная погрешность.
+ * @return Достигнутая относительная погрешность.
+ */
+extern double utable_build(const func_points_t* points, utable_t* table, double tol = UTABLE_TOL);
+
+/**
+ * @brief Значение функции по равномерной таблице.
+ * @details За пределами диапазона возвращаются крайние значения, как в in_LinearFunc().
+ * @param table - равномерная таблица.
+ * @param x - значение аргумента.
+ */
+inline double utable_val(const utable_t* table, double x)
+{
+	x = (x < table->xmin) ? table->xmin : ((x > table->xmax) ? table->xmax : x);
+	int i = (int)((x - table->xmin)*table->inv);
+	if (i >= table->count)
+		i = table->count-1;
+	return table->ab[2*i] + table->ab[2*i+1]*x;
+}
+
+/**
+ * @brief Таблица первообразной равномерной таблицы.
+ * @details Интеграл от 0 до x функции, заданной равномерной таблицей (за пределами
+ * диапазона функция постоянна). На каждом интервале i первообразная - парабола
+ * abc[3i] + abc[3i+1]*x + abc[3i+2]*x^2, значения на интервалах - префиксные суммы.
+ */
 typedef struct {
-	/** Указатель на функцию интерполяции одного переменного. */
-	IFunc* func;
-	/** Значение аргумента. */
-	double valY;
-} table_t;
-/** Класс предоставляет инструменты интерполяции физической величины по двум параметрам. */
-class ITable {
-	/** Хранилище аргументов и значений функции. */
-	vector<table_t*> func2D;
-public:
-	/** Конструктор класса. */
-	ITable();
-	/**
-	 * @brief Добавить набор значений функции для второго аргумента
-	 * @param func - указатель на функцию одного аргумента.
-	 * @param valY - значение второго аргумента
-	 */
-	void add(IFunc* func, double valY);
-	/** Выдать значение функции интерполяции
-	 * @param x - значение первого аргумента функции интерполяции.
-	 * @param y - значение второго аргумента функции интерполяции.
-	 */
-	double val(double x, double y);
-
-	/** Деструктор класса. */
-	~ITable();
-};
-typedef struct {
-	/** Указатель на функцию интерполяции двух переменных. */
-	ITable* func;
-	/** Значение аргумента. */
-	double valZ;
-} cube_t;
-class ICube {
-	/** Хранилище аргументов и значений функции. */
-	vector<cube_t*> func3D;
-public:
-	/** Конструктор класса. */
-	ICube();
-	/**
-	 * @brief Добавить набор значений функции для второго аргумента
-	 * @param valZ - значение третьего аргумента.
-	 * @param tbl - набор значений двумерной табличной функции
-	 */
-	void add(ITable* tbl, double valZ);
-	/** Выдать значение функции интерполяции
-	 * @param x - значение первого аргумента функции интерполяции.
-	 * @param y - значение второго аргумента функции интерполяции.
-	 * @param y - значение третьего аргумента функции интерполяции.
-	 */
-	double val(double x, double y, double z);
-
-	/** Деструктор класса. */
-	~ICube();
-};
+	/** Границы диапазона аргумента. */
+	double xmin, xmax;
+	/** Величина, обратная шагу сетки. */
+	double inv;
+	/** Коэффициенты парабол на интервалах (по три на интервал). */
+	double *abc;
+	/** Количество интервалов. */
+	int count;
+	/** Значения функции левее и правее диапазона. */
+	double ylo, yhi;
+	/** Значение первообразной на правой границе диапазона. */
+	double Fhi;
+} qtable_t;
+
+/**
+ * @brief Построить таблицу первообразной.
+ * @details Совпадает с ma_integral() для исходной таблицы интерполяции, если
+ * равномерная таблица построена без погрешности.
+ * @param f - равномерная таблица функции.
+ * @param F - строимая таблица. Память выделяется функцией: F->abc равно 0
+ * или указывает на коэффициенты ранее построенной таблицы, которые переиспользуются.
+ */
+extern void qtable_build(const utable_t* f, qtable_t* F);
+
+/**
+ * @brief Значение первообразной: интеграл от 0 до x.
+ * @param F - таблица первообразной.
+ * @param x - верхний предел интегрирования.
+ */
+inline double qtable_val(const qtable_t* F, double x)
+{
+	if (x <= F->xmin)
+		return F->ylo*x;
+	if (x >= F->xmax)
+		return F->Fhi + F->yhi*(x - F->xmax);
+	int i = (int)((x - F->xmin)*F->inv);
+	if (i >= F->count)
+		i = F->count-1;
+	const double* c = &(F->abc[3*i]);
+	return c[0] + x*(c[1] + x*c[2]);
+}
+
+#include <vector>
+using namespace std;
+
 #endif /* MATH_ADDONS_H */
 
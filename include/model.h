@@ -10,9 +10,44 @@
 
 #include <common.h>
 #include <material.h>
+#include <arena.h>
 /** Прототип граничного условия. */
 class CBoundary;
 
+/**
+ * @brief Preferences of the adaptive remeshing.
+ */
+typedef struct {
+	/** Minimum cell width, [m]. */
+	double WMIN;
+	/** Maximum cell width, [m]. */
+	double WMAX;
+	/** Temperature jump between neighbouring cells which requires refinement, [K]. */
+	double DT_REFINE;
+	/**
+	 * Temperature jump of a merged pair of cells to its neighbours which allows
+	 * coarsening, [K]. Not above DT_REFINE/2, so a merged cell isn't split again
+	 * and a split cell isn't merged back until the temperatures change.
+	 */
+	double DT_COARSEN;
+	/** Maximum number of cells of the model. */
+	int NMAX;
+	/** Time between remeshings, [s] (0 - after every step). */
+	double PERIOD;
+} remesh_t;
+
+/**
+ * @brief Range of neighbouring cells of one material.
+ */
+typedef struct {
+	/** First cell of the range. */
+	int first;
+	/** Last cell of the range. */
+	int last;
+	/** Material of the cells. */
+	CMaterial* M;
+} layer_t;
+
 /**
  * @brief Тепловая модель пакета материалов
  */
@@ -22,12 +57,19 @@ public:
 	CBoundary *LBC;
 	/** Pointer to the right boundary */
 	CBoundary *RBC;
-	/** Pointer to material at each cell. */
-	CMaterial *m[CELLS_MAX_NUM];
+	/** Index of material at each cell, in materials. */
+	unsigned char *mid;
+	/** Materials of the model, in order of addition. */
+	vector<CMaterial*> materials;
+	/**
+	 * Ranges of cells with the same material, from cell 0 to lcnum.
+	 * Cropped cells are kept: ranges must be clipped by fcnum.
+	 */
+	vector<layer_t> layers;
 	/** Cell temperature */
-	double T[CELLS_MAX_NUM];
+	double *T;
 	/** Cell width */
-	double width[CELLS_MAX_NUM];
+	double *width;
 	/** First cell number at the Model (connected to the left boundary) */
 	int fcnum;
 	/** Last cell number at the Model (connected to the left boundary) */
@@ -50,6 +92,22 @@ public:
 	 * @brief Class constructor.
 	 */
 	thm_t();
+	/**
+	 * @brief Copy constructor. Cell arrays are copied, boundaries are shared.
+	 */
+	thm_t(const thm_t& thm);
+	/**
+	 * @brief Assignment. Cell arrays are copied, boundaries are shared.
+	 */
+	thm_t& operator=(const thm_t& thm);
+	/**
+	 * @brief Reserve storage for the cells of the model.
+	 * @details Existing cells are kept. Storage never shrinks.
+	 * @param cells - number of cells.
+	 */
+	void reserve(int cells);
+	/** Returns maximum number of cells without storage reallocation. */
+	int capacity() const;
 	/**
 	 * @brief Add new layer to the right side of TPS
 	 * @param Cells - Number of cells in the TPS layer
@@ -65,6 +123,20 @@ public:
 	 * @param dx - value of deleting width, [m].
 	 */
 	int crop(int side, double dx);
+	/**
+	 * @brief Move the left boundary by uniform shrinking of the surface cells.
+	 * @details Used by the moving grid instead of crop(): cell temperatures
+	 * are kept, widths of the first cells are scaled to remove dx.
+	 * @param dx - recession of the left boundary, [m].
+	 * @param cells - number of the surface cells to shrink.
+	 * @return Scale factor of the cell widths.
+	 */
+	double recede(double dx, int cells);
+	/**
+	 * @brief Thickness of the first cells of the model.
+	 * @param cells - number of cells.
+	 */
+	double thickness(int cells);
 	/** Returns length of the model. */
 	double length();
 	/** Set left boundary.
@@ -75,11 +147,94 @@ public:
 	 * @param BC - pointer tj the boundary.
 	 */
 	void setRBC(CBoundary* BC);
+	/**
+	 * @brief Replace a material of the model.
+	 * @param k - index of the material, in materials.
+	 * @param M - new material.
+	 */
+	void setMaterial(int k, CMaterial* M);
+	/**
+	 * @brief Change the thickness of a range of cells before the solution.
+	 * @details Cells of the range keep their number and relative widths, the
+	 * following cells are shifted.
+	 * @param k - range number, in layers.
+	 * @param dx - new thickness of the range, [m].
+	 */
+	void setThickness(int k, double dx);
 	/** Set non-uniform tempareture by interpolation function
 	 * @param Tf - pointer to the temperature-by-coordinate interpolation function
 	 */
 	void setTemperature(func_points_t * Tf);
+	/**
+	 * @brief Write the state of the model to a binary checkpoint.
+	 * @details Materials are not written: the model is loaded into a copy
+	 * parsed from the same input file.
+	 * @param f - checkpoint file.
+	 */
+	void save(FILE* f) const;
+	/**
+	 * @brief Read the state of the model from a binary checkpoint.
+	 * @param f - checkpoint file.
+	 * @return SUCCESS or NULL_VALUE if the file is too short or the materials differ.
+	 */
+	int load(FILE* f);
+	/**
+	 * @brief Adapt the mesh to the temperature field.
+	 * @details Cells with a steep temperature jump to a neighbour are split in
+	 * two while the number of cells stays within NMAX, from the surface inwards.
+	 * Pairs of cells of the same material are merged if the merged cell has a
+	 * small jump to its neighbours. Temperatures are remapped with conservation
+	 * of the heat quantity.
+	 * Cells never cross material boundaries. Ablated cells are dropped, so
+	 * after the call fcnum is 0.
+	 * @param prefs - remeshing preferences.
+	 * @return Number of cells at the model after remeshing.
+	 */
+	int remesh(const remesh_t& prefs);
+	/**
+	 * @brief Reserve storage for remesh() before the time march.
+	 * @details remesh() never makes more cells than the larger of NMAX and
+	 * the current number of cells. Both meshes are sized for it, so remesh()
+	 * makes no allocations.
+	 * @param prefs - remeshing preferences.
+	 */
+	void reserve(const remesh_t& prefs);
+	/**
+	 * @brief Temperature at the centre of a cell of the initial mesh.
+	 * @details Until the mesh is changed returns T[cell]. After that the value
+	 * is interpolated at the initial centre coordinate of the cell; ablated
+	 * cells keep the temperature they had when the surface passed them.
+	 * @param cell - cell number at the initial mesh.
+	 */
+	double cellT(int cell);
+	/**
+	 * @brief Material of a cell.
+	 * @param i - cell number.
+	 */
+	CMaterial* material(int i) const
+	{
+		return materials[mid[i]];
+	}
 	void print();
+private:
+	/** Storage of the cell arrays. */
+	CArena arena;
+	/** Number of cells the storage is sized for. */
+	int CAPACITY;
+	/** Storage of the previous mesh, reused by remesh(). */
+	CArena spare;
+	/** Centre coordinates of the initial mesh cells, counted from the initial left boundary, [m]. */
+	vector<double> X0;
+	/** Temperatures of the initial mesh cells at the moment of their ablation. */
+	vector<double> TA;
+	/** Number of the initial mesh cells with known ablation temperature. */
+	int ABLATED;
+	/** Cells don't keep their initial positions: remesh() or recede() was called. */
+	bool MOVED;
+	/** Start tracking the initial mesh cells by coordinate. */
+	void track();
+	/** Rebuild the layer ranges by the material indices. */
+	void index();
 };
 
 #endif /* _MODEL_H_ */
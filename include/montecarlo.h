@@ -0,0 +1,127 @@
+/**
+ * @file montecarlo.h
+ * @brief Monte Carlo sampling of the uncertain input data.
+ * @copyright MIT License
+ */
+
+#ifndef _MONTECARLO_H_
+#define _MONTECARLO_H_
+
+#include <common.h>
+#include <cstdint>
+#include <avdtparser.h>
+#include <heatflux.h>
+
+/** Maximum number of the uncertain parameters. */
+#define MC_PARAMS_MAX		(64)
+
+/** Normal distribution: mean and standard deviation. */
+#define MC_NORMAL		(0)
+/** Uniform distribution: lower and upper bounds. */
+#define MC_UNIFORM		(1)
+/** Normal draws are truncated to MEAN +/- MC_SIGMAS*SIGMA. */
+#define MC_SIGMAS		(3.)
+/** Maximum number of redraws of a truncated normal value. */
+#define MC_REDRAWS_MAX		(64)
+
+/** Uncertain parameter of the input data. */
+typedef struct {
+	/** Index of the parameter name. */
+	int TARGET;
+	/** Material number, 1...materials (0 - all materials). */
+	int MATERIAL;
+	/** Distribution: MC_NORMAL or MC_UNIFORM. */
+	int DIST;
+	/** Parameters of the distribution. */
+	double A, B;
+} mc_param_t;
+
+/**
+ * @brief Uncertain input data and their sampling.
+ * @details Each line of the definition file is "NAME[:MATERIAL] normal MEAN SIGMA"
+ * or "NAME[:MATERIAL] uniform LOW HIGH", '#' starts a comment. Names:
+ * LAYER_L, LAYER_CP, LAYER_D, LAYER_EPS, LAYER_A, LAYER_B - factors of the
+ * material properties (of all materials or of the given one, in order of
+ * appearance in the TPS file), Q - factor of the heat flux, H, V, AL -
+ * offsets of the trajectory altitude (m), velocity (m/s) and angle of attack
+ * (deg).
+ * Normal values are truncated to MEAN +/- MC_SIGMAS*SIGMA by redrawing. The
+ * lower limit of a factor must be positive, and the offsets must keep the
+ * altitude and velocity of the trajectory non-negative (see check()).
+ * Values are drawn by a counter-based generator: the value of a parameter
+ * depends only on the seed, number of the realisation and number of the
+ * parameter, so the samples don't depend on the number of threads and on
+ * the order of evaluation.
+ */
+class CMonteCarlo {
+	/** Uncertain parameters. */
+	vector<mc_param_t> params;
+	/** Seed of the generator. */
+	uint64_t SEED;
+public:
+	/**
+	 * @brief Load the definition of the uncertain parameters.
+	 * @param filename - definition file.
+	 * @param seed - seed of the generator.
+	 */
+	CMonteCarlo(const char* filename, uint64_t seed);
+	/** Return number of the uncertain parameters. */
+	int count() const;
+	/** Return the parameter k. */
+	const mc_param_t& param(int k) const;
+	/** Return the lowest value of the parameter k. */
+	double lower(int k) const;
+	/**
+	 * @brief Name of the parameter k, "NAME" or "NAME:MATERIAL".
+	 * @param k - parameter number.
+	 * @param name - buffer of FILENAME_MAX_LEN characters.
+	 */
+	void name(int k, char* name) const;
+	/**
+	 * @brief Check the parameters against the input data.
+	 * @details The parameters must refer to the materials of the model, and
+	 * the lowest offsets must keep the altitude and velocity of the trajectory
+	 * non-negative.
+	 * @return SUCCESS or NULL_VALUE.
+	 */
+	int check(const thm_t* thm, const trm_t* trm) const;
+	/**
+	 * @brief Draw the parameters of a realisation.
+	 * @param n - number of the realisation.
+	 * @param values - values of the parameters, count() values (output).
+	 */
+	void sample(long n, double* values) const;
+};
+
+/**
+ * @brief Input data of one realisation.
+ * @details Copies of the trajectory and of the thermal model with the
+ * perturbed data. Materials of the model are replaced by scaled copies, the
+ * shared base materials and heat flux source are not changed.
+ */
+class CRealisation {
+	/** Scaled materials of the model. */
+	vector<CMaterial*> materials;
+	/* Model refers to the owned materials and can't be copied. */
+	CRealisation(const CRealisation&);
+	CRealisation& operator=(const CRealisation&);
+public:
+	/** Perturbed trajectory. */
+	trm_t trm;
+	/** Thermal model with the perturbed materials. */
+	thm_t thm;
+	/** Perturbed heat flux. */
+	CScaledHeatFlux flux;
+	/**
+	 * @brief Build the input data of a realisation.
+	 * @param mc - uncertain parameters.
+	 * @param values - values of the parameters, mc.count() values.
+	 * @param trm - nominal trajectory.
+	 * @param thm - nominal thermal model.
+	 * @param flux - nominal heat flux source.
+	 */
+	CRealisation(const CMonteCarlo& mc, const double* values, const trm_t* trm, const thm_t* thm, const CHeatFlux* flux);
+	~CRealisation();
+};
+
+#endif /* _MONTECARLO_H_ */
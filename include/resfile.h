@@ -0,0 +1,126 @@
+/**
+ * @file resfile.h
+ * @brief Binary columnar file of the results table.
+ * @details The file starts with the header: signature RES_MAGIC, number of
+ * columns, number of print cells and their numbers (int32), then header and
+ * printf format of each column (RES_NAME_LEN characters each). Rows follow
+ * in blocks: number of rows of the block (int32), then the values of each
+ * column of the block in turn (double). Values are in native byte order.
+ * @copyright MIT License
+ */
+
+#ifndef _RESFILE_H_
+#define _RESFILE_H_
+
+#include <common.h>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/** Signature of the binary results file. */
+#define RES_MAGIC		"AVDRES2"
+/** Length of the column header and format, including the terminating zero. */
+#define RES_NAME_LEN	(16)
+/** Number of rows in the block. */
+#define RES_BLOCK_ROWS	(256)
+/** Maximum time the rows wait in the block buffer before writing, s. */
+#define RES_FLUSH_PERIOD	(1.)
+
+/** Column of the results table. */
+typedef struct {
+	/** Header of the column as printed in the text table. */
+	char NAME[RES_NAME_LEN];
+	/** printf format of the value in the text table. */
+	char FORMAT[RES_NAME_LEN];
+} res_column_t;
+
+/**
+ * @brief Writer of the binary results file.
+ * @details Rows are collected in one of two block buffers while a background
+ * thread writes the other one, so the computing thread only copies values
+ * and waits only if the disk is slower than the computation. A block is
+ * written when it is full or RES_FLUSH_PERIOD after its first row, so the
+ * file keeps up with a slow computation.
+ */
+class CResultWriter {
+	/** Results file. */
+	FILE* f;
+	/** Number of columns. */
+	int COLUMNS;
+	/** Block buffers, values of column c of row r are at c*RES_BLOCK_ROWS+r. */
+	vector<double> buffer[2];
+	/** Buffer filled by write() and number of its rows. */
+	int current, rows;
+	/** Time of the first row of the current buffer. */
+	chrono::steady_clock::time_point first;
+	/** Buffer given to the background thread (-1 - none) and number of its rows. */
+	int pending, prows;
+	/** Background thread must exit after writing the pending buffer. */
+	bool stop;
+	/** Some write failed. */
+	bool failed;
+	thread worker;
+	mutex lock;
+	condition_variable ready;
+	condition_variable written;
+	/** Allocate the buffers and start the background thread. */
+	void start();
+	/** Main loop of the background thread. */
+	void run();
+	/** Give the current buffer to the background thread. */
+	void flush();
+	/* Writer owns its thread and file and can't be copied. */
+	CResultWriter(const CResultWriter&);
+	CResultWriter& operator=(const CResultWriter&);
+public:
+	/**
+	 * @brief Create the file and write the header.
+	 * @details If the file can't be created, the message is printed and
+	 * isOpen() is false.
+	 * @param filename - name of the file.
+	 * @param columns - columns of the table.
+	 * @param cells - numbers of the print cells.
+	 */
+	CResultWriter(const char* filename, const vector<res_column_t>& columns, const vector<int>& cells);
+	/**
+	 * @brief Continue the file from a checkpoint.
+	 * @details The rows after the checkpoint are discarded. If the file can't
+	 * be restored, the message is printed and isOpen() is false.
+	 * @param filename - name of the file.
+	 * @param columns - number of columns of the table.
+	 * @param size - length of the file at the checkpoint (see sync()), bytes.
+	 */
+	CResultWriter(const char* filename, int columns, long size);
+	/** Class destructor. Calls close(). */
+	~CResultWriter();
+	/** Return true if the file is created and not closed yet. */
+	bool isOpen() const;
+	/**
+	 * @brief Add a row.
+	 * @param values - values of the columns.
+	 */
+	void write(const double* values);
+	/**
+	 * @brief Write the collected rows and wait until they are in the file.
+	 * @param size - length of the file, bytes (output).
+	 * @return SUCCESS or NULL_VALUE if some write failed.
+	 */
+	int sync(long* size);
+	/**
+	 * @brief Write the remaining rows and close the file.
+	 * @return SUCCESS or NULL_VALUE if the file wasn't created or some write failed.
+	 */
+	int close();
+};
+
+/**
+ * @brief Convert the binary results file to the text table.
+ * @param filename - binary results file.
+ * @param out - text output.
+ * @return SUCCESS or NULL_VALUE if the file can't be read.
+ */
+int res_convert(const char* filename, FILE* out);
+
+#endif /* _RESFILE_H_ */
@@ -0,0 +1,33 @@
+/**
+ * @file sizing.h
+ * @brief Подбор толщины слоёв ТЗП по допустимой температуре ячейки.
+ * @copyright MIT License
+ */
+
+#ifndef _SIZING_H_
+#define _SIZING_H_
+
+#include <avdrun.h>
+
+/**
+ * @brief Подбор минимальной толщины слоёв ТЗП по допустимой температуре ячейки.
+ * @details Толщины выбранных слоёв изменяются в одно и то же число раз. На каждой
+ * итерации внутри интервала между ближайшими непрошедшим и прошедшим вариантами
+ * рассчитывается по варианту на поток, интервал сужается до соседних вариантов
+ * с разным исходом. Множитель, при котором TPEAK = TMAX, оценивается по TPEAK
+ * двух самых тонких прошедших вариантов, рассчитанных до конца (метод секущих;
+ * расчёт непрошедших вариантов прекращается при превышении TMAX, и их TPEAK не
+ * годится для интерполяции). Пара вариантов ставится на расстоянии SIZING_TOL/2
+ * от оценки, остальные делят интервал поровну. Если оценки нет или на прошлой
+ * итерации интервал сузился меньше чем вдвое, интервал делится поровну всеми
+ * вариантами. Если номинальная толщина не проходит, интервал расширяется вверх
+ * удвоением. Вариант, который невозможно рассчитать, считается непрошедшим.
+ * @param layers - номера слоёв (диапазонов ячеек одного материала от поверхности).
+ * @param CELL - номер контролируемой ячейки.
+ * @param TMAX - допустимая температура ячейки, К.
+ * @param fout - файл результатов.
+ */
+void sizing(vector<int> layers, int CELL, double TMAX, FILE* fout, const options_t& opt,
+	trm_t* trm, thm_t* thm, gasdynamics_t* gd, CBluntedCone* BCone, const print_t& prn);
+
+#endif /* _SIZING_H_ */
@@ -0,0 +1,107 @@
+/**
+ * @file surfacemap.h
+ * @brief Surface heating map: many points of the vehicle surface marched together.
+ * @copyright MIT License
+ */
+
+#ifndef _SURFACEMAP_H_
+#define _SURFACEMAP_H_
+
+#include <common.h>
+#include <avdsolver.h>
+#include <threadpool.h>
+
+/**
+ * @brief Heating and recession of a grid of (x, phi) points of the surface.
+ * @details Every point (station) has its own model and AVDSolver. All stations
+ * are marched with one common time step: the free stream (trajectory and
+ * atmosphere) is evaluated once per step, the heat flux of all stations is
+ * computed by one batch call, then the steps of the stations run in
+ * parallel on the thread pool by groups of TDMA_LANES stations. The thermal
+ * tasks of a group are solved together by a pack of thermal solvers, the
+ * stations the pack doesn't take are solved one by one. The next common step
+ * is the smallest step recommended by the stations.
+ */
+class CSurfaceMap {
+	/** Trajectory of the vehicle. */
+	trm_t* trm;
+	/** Pool of threads for the station steps. */
+	CThreadPool* pool;
+	/** Solvers of the stations. */
+	vector<AVDSolver*> solver;
+	/** Axis coordinates of the stations, [m]. */
+	vector<double> X;
+	/** Meridional angles of the stations, [deg]. */
+	vector<double> PHI;
+	/** Last results of the stations. */
+	vector<avdsolver_t> result;
+	/** Free stream of the current step. */
+	flow_t flow;
+	/** Heat-flux inputs and results of the stations. */
+	avd_batch_t batch;
+	/** Stations of the batch: the ones not found in their caches. */
+	vector<int> miss;
+	/** Packs of thermal solvers, one per group of stations. */
+	vector<CTHSolverPack*> packs;
+	/** Common time step. */
+	double TIMESTEP;
+	/** Cursor of the trajectory time axis. */
+	int CURSOR;
+	/* Map refers to the solvers of the caller and can't be copied. */
+	CSurfaceMap(const CSurfaceMap&);
+	CSurfaceMap& operator=(const CSurfaceMap&);
+public:
+	/**
+	 * @brief Class constructor.
+	 * @param trm - trajectory of the vehicle.
+	 * @param pool - pool of threads.
+	 */
+	CSurfaceMap(trm_t* trm, CThreadPool* pool);
+	/** Class destructor. */
+	~CSurfaceMap();
+	/**
+	 * @brief Add station.
+	 * @details The model of the solver must be at the same CURRENT_TIME as
+	 * the models of the other stations.
+	 * @param x - axis coordinate of the station, [m].
+	 * @param phi - meridional angle of the station, [deg].
+	 * @param solver - solver of the station.
+	 * @return Station number.
+	 */
+	int add(double x, double phi, AVDSolver* solver);
+	/** Return number of stations. */
+	int count() const;
+	/** Return solver of the station. */
+	AVDSolver* station(int s);
+	/** Return axis coordinate of the station, [m]. */
+	double x(int s) const;
+	/** Return meridional angle of the station, [deg]. */
+	double phi(int s) const;
+	/** Return last results of the station. */
+	const avdsolver_t& info(int s) const;
+	/** Return number of groups of stations. */
+	int groups() const;
+	/**
+	 * @brief Make the current step of a group of stations with the heat flux of the batch.
+	 * @details Group g holds the stations from g*TDMA_LANES up to TDMA_LANES stations.
+	 * @param g - group number.
+	 */
+	void Step(int g);
+	/**
+	 * @brief March all stations to time.
+	 * @param time - next stop point of timeline.
+	 */
+	void Solve(double time);
+	/**
+	 * @brief Print header of the map.
+	 * @param out - pointer to the output device.
+	 */
+	static void printHeader(FILE* out);
+	/**
+	 * @brief Print current state of all stations, one line per station.
+	 * @param out - pointer to the output device.
+	 */
+	void print(FILE* out);
+};
+
+#endif /* _SURFACEMAP_H_ */
@@ -1,19 +1,187 @@
 #ifndef _TDMA_H_
 #define _TDMA_H_
+
+/**
+ *  ,     
+ * (      SIMD-).
+ */
+#if defined(__AVX512F__)
+#define TDMA_LANES		(8)
+#elif defined(__AVX2__)
+#define TDMA_LANES		(4)
+#else
+#define TDMA_LANES		(4)
+#endif
+/**
+ * @brief    ( ).
+ * @details       ( 
+ *  ),      
+ *   .
+ */
+class CTDMASolver {
+	/**   T[i-1]. */
+	double* A;
+	/**   T[i+1]. */
+	double* B;
+	/**  . */
+	double* C;
+	/**   . */
+	double* F;
+	/**  . */
+	double* alpha;
+	/**  . */
+	double* betta;
+	/**   ,     . */
+	int CAPACITY;
+	/**     . */
+	bool isOwner;
+	/**     . */
+	void attach(double* workspace);
+	/**     . */
+	void TDMA(double* T, int LAST);
+	/*  :      . */
+	CTDMASolver(const CTDMASolver&);
+	CTDMASolver& operator=(const CTDMASolver&);
+public:
+	/**
+	 * @brief  .      setWorkspace().
+	 */
+	CTDMASolver();
+	/**
+	 * @brief  .    .
+	 * @param capacity -     .
+	 */
+	CTDMASolver(int capacity);
+	/**
+	 * @brief  .     .
+	 * @param workspace -     workspaceSize(capacity).
+	 * @param capacity -     .
+	 */
+	CTDMASolver(double* workspace, int capacity);
+	/**  . */
+	~CTDMASolver();
+	/**
+	 * @brief   ,   double.
+	 * @param capacity -     .
+	 */
+	static int workspaceSize(int capacity);
+	/**     . */
+	int capacity() const;
+	/**
+	 * @brief       .
+	 * @param workspace -     workspaceSize(capacity).
+	 * @param capacity -     .
+	 */
+	void setWorkspace(double* workspace, int capacity);
+	/**
+	 *   .
+	 * @param Temp -  .
+	 * @param Width -   .
+	 * @param VolHeatSrc -  .
+	 * @param HeatCond -  .
+	 * @param Density -  .
+	 * @param SpecHeat -  .
+	 * @param eps -      .
+	 * @param thau -  .
+	 * @param size -    .
+	 * @param theta -    : 1 -  , 0.5 -  -,
+	 * 0 -   ( ).
+	 *       .
+	 * @param Tlin - ,      
+	 * ( ).  Tlin = 0    Temp.
+	 * @param GridVel -    , / ( ),  0.
+	 */
+	void Calculate(	double* Temp, double* Width, double* VolHeatSrc,
+			double* HeatCond, double* Density, double* SpecHeat,
+			double Eps[2], double thau, int size, double theta = 1.,
+			const double* Tlin = 0, const double* GridVel = 0);
+	/**
+	 * @brief      .
+	 * @details    C[i]*X[i] = A[i]*X[i-1] + B[i]*X[i+1] + F[i],
+	 *  A[0]  B[size-1]  .
+	 * @param X - ,    .
+	 * @param size -  .
+	 */
+	void Solve(	const double* A, const double* B, const double* C, const double* F,
+			double* X, int size);
+};
+
 /**
- *   .
- * @param Temp -  . 
- * @param Width -   .
- * @param VolHeatSrc -  .
- * @param HeatCond -  .
- * @param Density -  .
- * @param SpecHeat -  . 
- * @param eps -      .
- * @param thau -  .
- * @param size -    .
+ * @brief   .
+ * @details    TDMA_LANES   
+ * .      :  i
+ *  k    i*TDMA_LANES+k,    
+ *      (AVX-512, AVX2   ).
  */
-extern void CalculateTDMA(	double* Temp, double* Width, double* VolHeatSrc,
-					double* HeatCond, double* Density, double* SpecHeat,
-					double Eps[2], double thau, int size);
+class CTDMABatch {
+	/**   T[i-1]. */
+	double* A;
+	/**   T[i+1]. */
+	double* B;
+	/**  . */
+	double* C;
+	/**   . */
+	double* F;
+	/**  . */
+	double* alpha;
+	/**  . */
+	double* betta;
+	/**    . */
+	double* X;
+	/**      . */
+	int CAPACITY;
+	/**     . */
+	bool isOwner;
+	/**    . */
+	int assembled;
+	/**     . */
+	void attach(double* workspace);
+	/*  :      . */
+	CTDMABatch(const CTDMABatch&);
+	CTDMABatch& operator=(const CTDMABatch&);
+public:
+	/**
+	 * @brief  .    .
+	 * @param capacity -      .
+	 */
+	CTDMABatch(int capacity);
+	/**
+	 * @brief  .     .
+	 * @param workspace -     workspaceSize(capacity),   64 .
+	 * @param capacity -      .
+	 */
+	CTDMABatch(double* workspace, int capacity);
+	/**  . */
+	~CTDMABatch();
+	/**
+	 * @brief   ,   double.
+	 * @param capacity -      .
+	 */
+	static int workspaceSize(int capacity);
+	/**      . */
+	int capacity() const;
+	/**
+	 * @brief     lane.
+	 * @details    CTDMASolver::Calculate().  Temp  .
+	 * @param lane -  , [0...TDMA_LANES-1].
+	 */
+	void Assemble(	int lane, double* Temp, double* Width, double* VolHeatSrc,
+			double* HeatCond, double* Density, double* SpecHeat,
+			double Eps[2], double thau, int size, double theta = 1.,
+			const double* Tlin = 0);
+	/**
+	 * @brief      .
+	 * @details      .
+	 * @param size -     .
+	 */
+	void Solve(int size);
+	/**
+	 * @brief      lane.
+	 * @param lane -  .
+	 * @param Temp - ,    .
+	 * @param size -    .
+	 */
+	void Result(int lane, double* Temp, int size) const;
+};
 
 #endif /* _TDMA_H_ */
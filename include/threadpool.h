@@ -0,0 +1,83 @@
+/**
+ * @file threadpool.h
+ * @brief Pool of worker threads for the parallel line and station solves.
+ * @copyright MIT License
+ */
+
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+
+#include <common.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/**
+ * @brief Task executed by the pool.
+ * @details run() is called once for each item of the task, items are
+ * distributed between the threads dynamically.
+ */
+class CTask {
+public:
+	virtual ~CTask() {}
+	/**
+	 * @brief Process one item of the task.
+	 * @param index - item number, [0...count-1].
+	 * @param thread - number of the executing thread, [0...threads-1].
+	 */
+	virtual void run(int index, int thread) = 0;
+};
+
+/**
+ * @brief Pool of worker threads.
+ * @details The calling thread takes part in each run() as thread 0, so a pool
+ * of one thread executes tasks sequentially without any workers. run() is not
+ * reentrant: tasks must not call run() of the same pool.
+ */
+class CThreadPool {
+	/** Worker threads (numbers 1...THREADS-1). */
+	vector<thread> workers;
+	/** Number of threads including the calling one. */
+	int THREADS;
+	/** Current task. */
+	CTask* task;
+	/** Number of items of the current task. */
+	int COUNT;
+	/** Next item to process. */
+	atomic<int> next;
+	/** Number of workers still processing the current task. */
+	int active;
+	/** Number of the current task, wakes the workers up. */
+	unsigned generation;
+	/** Workers must exit. */
+	bool stop;
+	mutex lock;
+	condition_variable start;
+	condition_variable done;
+	/** Main loop of the worker thread. */
+	void worker(int id);
+	/** Process items of the current task. */
+	void process(int id);
+	/* Pool owns its threads and can't be copied. */
+	CThreadPool(const CThreadPool&);
+	CThreadPool& operator=(const CThreadPool&);
+public:
+	/**
+	 * @brief Class constructor.
+	 * @param threads - number of threads or 0 for the number of hardware threads.
+	 */
+	CThreadPool(int threads = 0);
+	/** Class destructor. Waits for the workers to exit. */
+	~CThreadPool();
+	/** Return number of threads, including the calling one. */
+	int size() const;
+	/**
+	 * @brief Execute task for the items [0...count-1] and wait for the completion.
+	 * @param task - task to execute.
+	 * @param count - number of items.
+	 */
+	void run(CTask* task, int count);
+};
+
+#endif /* _THREADPOOL_H_ */
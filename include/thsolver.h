@@ -3,6 +3,14 @@
 
 #include <common.h>
 #include <model.h>
+#include <tdma.h>
+
+/** Backward Euler scheme with the temperature-jump step control. */
+#define SCHEME_EULER		(0)
+/** TR-BDF2 scheme with the embedded error estimate and the PI step-size controller. */
+#define SCHEME_TRBDF2		(1)
+/** Default maximum number of Picard iterations at an implicit stage. */
+#define PICARD_ITERS_STD	(20)
 
 /**     . */
 typedef struct {
@@ -20,24 +28,54 @@ typedef struct {
 	double LAST_TIMESTEP;
 	/** Maximum temperature change at the timestep. */
 	double CURRENT_DT_MAX;
+	/** Time step proposed by the step-size controller for the next call. */
+	double NEXT_TIMESTEP;
+	/** Number of accepted time steps. */
+	int STEPS;
+	/** Number of rejected time steps. */
+	int REJECTED;
+	/** Number of Picard iterations (tridiagonal solves) or 0 if Picard mode is off. */
+	int PICARD_ITERS;
+	/** Maximum number of Picard iterations at one implicit stage. */
+	int PICARD_MAX;
+	/** Number of implicit stages which didn't converge. */
+	int PICARD_FAILS;
+	/** Recession of the left boundary by the moving grid, [m]. */
+	double RECESSION;
 } solve_result_t;
 
+/**
+ * @brief Recession law of the left boundary.
+ * @details Used by the solver on the moving grid: the recession velocity is
+ * iterated together with the temperature field inside the time step.
+ */
+class CRecession {
+public:
+	virtual ~CRecession() {}
+	/**
+	 * @brief Recession velocity of the left boundary.
+	 * @param Tw - left boundary temperature, K.
+	 * @return Velocity, [m/s].
+	 */
+	virtual double velocity(double Tw) = 0;
+};
+
 /**         . */
 class CTHSolver {
 	/**    . */
 	thm_t *thm;
 	/**  , . */
-	double T[CELLS_MAX_NUM+2];
+	double *T;
 	/**   , .*/
-	double w[CELLS_MAX_NUM+2];
+	double *w;
 	/**    . */
-	double l[CELLS_MAX_NUM+2];
+	double *l;
 	/**  . */
-	double c[CELLS_MAX_NUM+2];
+	double *c;
 	/**  . */
-	double r[CELLS_MAX_NUM+2];
+	double *r;
 	/**     . */
-	double qv[CELLS_MAX_NUM+2];
+	double *qv;
 	/**     . */
 	int SIZE;
 	/**        . */
@@ -48,8 +86,63 @@ class CTHSolver {
 	double TIMESTEP_MAX;
 	/** Maximum temperature change per timestep or 0 */
 	double DT_MAX;
+	/** Time integration scheme: SCHEME_EULER or SCHEME_TRBDF2. */
+	int SCHEME;
+	/** Local error tolerance of the TR-BDF2 scheme, K. */
+	double TOL;
+	/** Scaled local error estimate of the last time step. */
+	double ERR;
+	/** Scaled local error estimate of the previous accepted time step. */
+	double ERR_PREV;
+	/** Time step proposed by the step-size controller. */
+	double NEXT_TIMESTEP;
+	/** Temperatures at the beginning of the time step (TR-BDF2). */
+	double *Tn;
+	/** Local error estimate accumulated over the stages (TR-BDF2). */
+	double *Est;
+	/** Maximum number of Picard iterations at an implicit stage or 0 (single linearized solve). */
+	int PICARD_ITERS_MAX;
+	/** Convergence tolerance of the Picard iterations, K. */
+	double PICARD_TOL;
+	/** Temperatures at the beginning of the implicit stage (Picard mode). */
+	double *Told;
+	/** Current Picard iterate (Picard mode). */
+	double *Tk;
+	/** Recession law of the left boundary or 0 (fixed grid). */
+	CRecession* recession;
+	/** Recession velocity at the last implicit stage, [m/s]. */
+	double VREC;
+	/** Number of cells of the surface layer moving with the left boundary. */
+	int RL;
+	/** Grid velocity in the cells, [m/s]. */
+	double *u;
+	/** Recession of the left boundary since the start of Solve(), [m]. */
+	double RECESSION;
+	/** Picard iteration counters since the start of Solve(). */
+	int PICARD_ITERS;
+	int PICARD_MAX;
+	int PICARD_FAILS;
 	/** Result of solving process. */
 	solve_result_t sres;
+	/** Tridiagonal solver with its own workspace. */
+	CTDMASolver tdma;
+	/** Storage of the solver arrays and the tridiagonal solver workspace. */
+	CArena arena;
+	/** Number of cells (with boundary cells) the storage is sized for. */
+	int CAPACITY;
+	/**
+	 * @brief Size the storage for the model with given number of cells.
+	 * @param cells - maximum number of cells at the model.
+	 */
+	void allocate(int cells);
+	/** Number of accepted time steps since the start of Solve(). */
+	int STEPS;
+	/** Number of rejected time steps since the start of Solve(). */
+	int REJECTED;
+	/** Left wall temperature before the last tridiagonal solve. */
+	double TWL_PREV;
+	/** Pack of solvers marching together needs access to the solver state. */
+	friend class CTHSolverPack;
 public:
 	/** 
 	 * @brief Class constructor. 
@@ -57,7 +150,7 @@ public:
 	 */
 	CTHSolver(thm_t* thm);
 	/**  . */
-	~CTHSolver();
+	virtual ~CTHSolver();
 	/**
 	 * @brief Solve thermal task from CURRENT_TIME to time
 	 * @param time - next stop point of timeline
@@ -82,12 +175,111 @@ public:
 	 * @param DT_MAX - maximum temperature change per timestep or 0 another
 	 */
 	void setPrefs(double TIMESTEP_MIN, double TIMESTEP_MAX, double DT_MAX = 1.);
+	/**
+	 * @brief Select time integration scheme.
+	 * @details With SCHEME_TRBDF2 the step size is chosen by the PI controller
+	 * from the local error estimate; DT_MAX and the step growth factor are not used.
+	 * @param SCHEME - SCHEME_EULER or SCHEME_TRBDF2.
+	 * @param TOL - local error tolerance, K.
+	 */
+	void setScheme(int SCHEME, double TOL = 1.);
+	/**
+	 * @brief Select Picard mode of the implicit stages.
+	 * @details Each implicit stage iterates the tridiagonal solve as a fixed-point
+	 * (Picard) iteration: the thermal properties are evaluated at the latest
+	 * iterate without their temperature derivatives, the boundary radiation is
+	 * linearized about it, until the temperature change is less than TOL.
+	 * @param ITERS_MAX - maximum number of iterations or 0 to switch Picard mode off.
+	 * @param TOL - convergence tolerance, K.
+	 */
+	void setPicard(int ITERS_MAX, double TOL = 1.0E-3);
+	/**
+	 * @brief Put the solver on the moving grid.
+	 * @details The cells of the surface layer (the cells adjacent to the left
+	 * boundary with the same material) are stretched between the receding left
+	 * boundary and the fixed back face of the layer (Landau transformation).
+	 * The grid velocity gives the convective term of the heat equation, and the
+	 * recession velocity is iterated with the temperatures at each implicit stage.
+	 * @param recession - recession law or 0 to switch the moving grid off.
+	 */
+	void setRecession(CRecession* recession);
+	/**
+	 * @brief Fill grid velocities of the surface layer.
+	 * @param V - recession velocity of the left boundary, [m/s].
+	 */
+	void GridVelocity(double V);
+	/**
+	 * @brief Solve one implicit stage.
+	 * @param Temp - temperatures at the beginning of the stage; the result is returned here.
+	 * @param thau - stage time step.
+	 * @param theta - weight of the implicit part of the scheme.
+	 * @return SUCCESS or NEED_SMALLER_STEP if Picard iterations don't converge.
+	 */
+	int Implicit(double* Temp, double thau, double theta = 1.);
+	/**
+	 * @brief Evaluate thermal properties of the cells and the boundary cells.
+	 * @param Temp - temperatures of the cells.
+	 */
+	void Properties(const double* Temp);
 	/**
 	 * @brief Do calculation of time step.
 	 * @param TIMESTEP - desired time step.
 	 * @return Result of iteration - SUCCESS or NO.
 	 */
 	int DoIteration(double TIMESTEP);
+	/**
+	 * @brief Do calculation of time step by the TR-BDF2 scheme.
+	 * @details Updates ERR by the embedded estimate of the local error built
+	 * from the stage values and the rate at the beginning of the step.
+	 * @param TIMESTEP - desired time step.
+	 * @return Result of iteration.
+	 */
+	int DoIterationTRBDF2(double TIMESTEP);
+	/**
+	 * @brief PI step-size controller.
+	 * @param TIMESTEP - accepted time step.
+	 * @return Proposed next time step.
+	 */
+	double Controller(double TIMESTEP);
+	/**
+	 * @brief Reset the solving result and prepare the internal model copy.
+	 */
+	void Begin();
+	/**
+	 * @brief Validate the temperatures obtained at the time step.
+	 * @param TIMESTEP - current time step.
+	 * @return Result of iteration - SUCCESS, NEED_SMALLER_STEP or TIMESTEP_MIN_CALCS.
+	 */
+	int Check(double TIMESTEP);
+	/**
+	 * @brief Accept the time step: advance the model time and update heat balance.
+	 * @details The moving grid shrinks the surface layer by the recession of
+	 * the step. If the step removes most of the layer, it is cropped instead,
+	 * so the next layer becomes the surface one.
+	 * @param TIMESTEP - accepted time step.
+	 * @param HeatQty_Pre - heat quantity before the time step, [J].
+	 * @param twlk - left wall temperature before the time step, K.
+	 * @param twrk - right wall temperature before the time step, K.
+	 */
+	void Accept(double TIMESTEP, double HeatQty_Pre, double twlk, double twrk);
+	/**
+	 * @brief Finalize the solving result.
+	 * @param dt - whole time interval of the Solve() call.
+	 */
+	void Finish(double dt);
+	/** Return result of the last Solve() call. */
+	const solve_result_t& result() const;
+	/**
+	 * @brief Write the step-size state of the solver to a binary checkpoint.
+	 * @param f - checkpoint file.
+	 */
+	void save(FILE* f) const;
+	/**
+	 * @brief Read the step-size state of the solver from a binary checkpoint.
+	 * @param f - checkpoint file.
+	 * @return SUCCESS or NULL_VALUE if the file is too short.
+	 */
+	int load(FILE* f);
 	/**
 	 * Init left and right boundary values.
 	 * @param lbc - pointer to the left boundary.
@@ -111,6 +303,12 @@ public:
 	 * return pointer to the thermal model.
 	 */
 	thm_t* getTHM();
+	/**
+	 * @brief Size the storage for the current capacity of the model.
+	 * @details Called after the model storage grows before the time march,
+	 * so that the steps make no allocations.
+	 */
+	void reserve();
 	/** Print preferences */
 	void printPreferences();
 	/** Return heat quantity. */
@@ -124,4 +322,48 @@ protected:
 	double Twr();
 };
 
+/**
+ * @brief Pack of thermal solvers, marching in lock-step.
+ * @details Each solver occupies one lane of the batched tridiagonal solver.
+ * All solvers use a common time step, which is reduced if any of them needs it.
+ * Solvers with another number of cells than the first one, or with more cells
+ * than the capacity of the pack, are solved by the scalar method at the same
+ * time step.
+ */
+class CTHSolverPack {
+	/** Solvers of the pack. */
+	CTHSolver* solver[TDMA_LANES];
+	/** Number of solvers at the pack. */
+	int COUNT;
+	/** Batched tridiagonal solver. */
+	CTDMABatch batch;
+public:
+	/**
+	 * @brief Class constructor.
+	 * @param capacity - maximum number of cells at the solver's model.
+	 */
+	CTHSolverPack(int capacity);
+	/**
+	 * @brief Add solver to the pack.
+	 * @param solver - pointer to the thermal solver.
+	 * @return Lane number or NULL_VALUE if the pack is full or the solver
+	 * doesn't use SCHEME_EULER (the only scheme of the pack), uses Picard mode
+	 * or the moving grid.
+	 */
+	int add(CTHSolver* solver);
+	/** Remove all solvers from the pack. */
+	void clear();
+	/** Return maximum number of cells (with boundary cells) solved by the batch. */
+	int capacity() const;
+	/** Return number of solvers at the pack. */
+	int count() const;
+	/**
+	 * @brief Solve thermal tasks of all solvers from CURRENT_TIME to time.
+	 * @details All models must have the same CURRENT_TIME.
+	 * @param time - next stop point of timeline.
+	 * @param res - array of COUNT results or 0.
+	 */
+	void Solve(double time, solve_result_t* res = 0);
+};
+
 #endif /* _THSOLVER_H_ */
@@ -0,0 +1,27 @@
+/**
+ * @file uncertainty.h
+ * @brief Оценка неопределённости результатов методом Монте-Карло.
+ * @copyright MIT License
+ */
+
+#ifndef _UNCERTAINTY_H_
+#define _UNCERTAINTY_H_
+
+#include <avdrun.h>
+#include <montecarlo.h>
+
+/**
+ * @brief Оценка неопределённости результатов методом Монте-Карло.
+ * @details Выводит в файл результатов значения параметров и результаты всех
+ * реализаций и статистику результатов: среднее, СКО, среднее+3СКО, минимум и максимум.
+ * Реализации, которые невозможно рассчитать, отмечаются как FAILED, их количество
+ * выводится, а статистика считается по остальным.
+ * @param filename - файл описания неопределённых параметров.
+ * @param samples - количество реализаций.
+ * @param seed - начальное значение генератора.
+ * @param fout - файл результатов.
+ */
+void monte_carlo(const char* filename, int samples, uint64_t seed, FILE* fout, const options_t& opt,
+	trm_t* trm, thm_t* thm, gasdynamics_t* gd, CBluntedCone* BCone, const print_t& prn);
+
+#endif /* _UNCERTAINTY_H_ */
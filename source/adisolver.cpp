@@ -0,0 +1,173 @@
+#include <adisolver.h>
+
+/** Lateral sweep: one line per cell number. */
+class CLateralTask : public CTask {
+public:
+	CADISolver* adi;
+	double thau;
+	virtual void run(int index, int thread)
+	{
+		adi->Line(index, thread, thau);
+	}
+};
+
+CADISolver::CADISolver(CBluntedCone* cone, CThreadPool* pool)
+{
+	assert(cone != 0);
+	assert(pool != 0);
+	this->cone = cone;
+	this->pool = pool;
+	for (int i=0; i<pool->size(); i++)
+		tdma.push_back(new CTDMASolver());
+	A = B = C = F = T = 0;
+	CAPACITY = 0;
+	TARGET = 0.;
+}
+
+CADISolver::~CADISolver()
+{
+	for (size_t i=0; i<tdma.size(); i++)
+		delete tdma[i];
+}
+
+void CADISolver::allocate()
+{
+	const int S = count();
+	if (S <= CAPACITY)
+		return;
+	const int n = S*pool->size();
+	const int ws = CTDMASolver::workspaceSize(S);
+	arena.reserve(5*CArena::align(n*sizeof(double))+pool->size()*CArena::align(ws*sizeof(double)));
+	A = arena.alloc<double>(n);
+	B = arena.alloc<double>(n);
+	C = arena.alloc<double>(n);
+	F = arena.alloc<double>(n);
+	T = arena.alloc<double>(n);
+	for (int i=0; i<pool->size(); i++)
+		tdma[i]->setWorkspace(arena.alloc<double>(ws), max(S, 2));
+	CAPACITY = S;
+}
+
+int CADISolver::add(double x, thm_t* thm)
+{
+	assert(thm != 0);
+	assert(X.empty() || (x > X.back()));
+	assert(this->thm.empty() || (thm->lcnum == this->thm[0]->lcnum));
+	this->thm.push_back(thm);
+	X.push_back(x);
+	G.push_back(cone->xgen(x));
+	RS.push_back(cone->mr(x));
+	return count()-1;
+}
+
+int CADISolver::count() const
+{
+	return (int)thm.size();
+}
+
+thm_t* CADISolver::station(int s)
+{
+	assert((s >= 0) && (s < count()));
+	return thm[s];
+}
+
+double CADISolver::x(int s) const
+{
+	assert((s >= 0) && (s < count()));
+	return X[s];
+}
+
+double CADISolver::target() const
+{
+	return TARGET;
+}
+
+void CADISolver::Line(int i, int thread, double thau)
+{
+	const int S = count();
+	double* A = this->A + thread*CAPACITY;
+	double* B = this->B + thread*CAPACITY;
+	double* C = this->C + thread*CAPACITY;
+	double* F = this->F + thread*CAPACITY;
+	double* T = this->T + thread*CAPACITY;
+	for (int first=0; first<S; ) {
+		/* Piece of the line where the cell isn't ablated. */
+		if ((i < thm[first]->fcnum) || (i > thm[first]->lcnum)) {
+			first++;
+			continue;
+		}
+		int last = first;
+		while ((last+1 < S) && (i >= thm[last+1]->fcnum) && (i <= thm[last+1]->lcnum))
+			last++;
+		if (last == first) {
+			first++;
+			continue;
+		}
+		/* Conductance of the face between stations s-1 and s. */
+		double Kl = 0.;
+		for (int s=first; s<=last; s++) {
+			const int k = s-first;
+			CMaterial* M = thm[s]->material(i);
+			double w = thm[s]->width[i];
+			double l = M->l(thm[s]->T[i]);
+			double rc = M->r(thm[s]->T[i])*M->c(thm[s]->T[i]);
+			double Kr = 0.;
+			if (s < last) {
+				CMaterial* Mn = thm[s+1]->material(i);
+				double ln = Mn->l(thm[s+1]->T[i]);
+				double area = (RS[s]+RS[s+1])/2.*(w+thm[s+1]->width[i])/2.;
+				Kr = area*(2.*l*ln/(l+ln))/(G[s+1]-G[s]);
+			}
+			/* Control volume of the station: halves of the distances to the neighbours. */
+			double gl = (s > 0) ? (G[s]-G[s-1])/2. : 0.;
+			double gr = (s < S-1) ? (G[s+1]-G[s])/2. : 0.;
+			double rl = (s > 0) ? (RS[s-1]+3.*RS[s])/4. : RS[s];
+			double rr = (s < S-1) ? (RS[s+1]+3.*RS[s])/4. : RS[s];
+			double V = w*(gl*rl+gr*rr);
+			assert(V > 0.);
+			A[k] = thau*Kl/(rc*V);
+			B[k] = thau*Kr/(rc*V);
+			C[k] = 1.+A[k]+B[k];
+			F[k] = thm[s]->T[i];
+			Kl = Kr;
+		}
+		tdma[thread]->Solve(A, B, C, F, T, last-first+1);
+		for (int s=first; s<=last; s++)
+			thm[s]->T[i] = T[s-first];
+		first = last+1;
+	}
+}
+
+void CADISolver::Lateral(double thau)
+{
+	assert(thau > 0.);
+	if (count() < 2)
+		return;
+	allocate();
+	int CELLS = 0;
+	for (int s=0; s<count(); s++)
+		CELLS = max(CELLS, thm[s]->lcnum+1);
+	CLateralTask task;
+	task.adi = this;
+	task.thau = thau;
+	pool->run(&task, CELLS);
+}
+
+void CADISolver::Solve(double time, double STEP, CTask* thickness)
+{
+	assert(count() > 0);
+	assert(STEP > 0.);
+	assert(thickness != 0);
+	while (thm[0]->CURRENT_TIME < time) {
+		double dt = min(STEP, time-thm[0]->CURRENT_TIME);
+		Lateral(dt/2.);
+		TARGET = thm[0]->CURRENT_TIME+dt;
+		pool->run(thickness, count());
+		/* Stations march with their own steps and may overshoot by the minimum step. */
+		for (int s=0; s<count(); s++) {
+			assert(fabs(thm[s]->CURRENT_TIME-TARGET) <= STD_TIMESTEP_MIN);
+			thm[s]->CURRENT_TIME = TARGET;
+		}
+		Lateral(dt/2.);
+	}
+}
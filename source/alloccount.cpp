@@ -0,0 +1,98 @@
+#include <alloccount.h>
+
+#ifdef AVD_COUNT_ALLOCS
+#include <new>
+#include <cerrno>
+
+/** Allocations of the thread. */
+static thread_local long ALLOCS = 0;
+
+long alloc_count()
+{
+	return ALLOCS;
+}
+
+#ifdef __GLIBC__
+/* The C allocator is replaced by counting wrappers over the glibc one. */
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size) noexcept
+{
+	ALLOCS++;
+	return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) noexcept
+{
+	ALLOCS++;
+	return __libc_calloc(n, size);
+}
+
+void* realloc(void* p, size_t size) noexcept
+{
+	ALLOCS++;
+	return __libc_realloc(p, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept
+{
+	ALLOCS++;
+	return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept
+{
+	ALLOCS++;
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** p, size_t alignment, size_t size) noexcept
+{
+	ALLOCS++;
+	*p = __libc_memalign(alignment, size);
+	return (*p == 0) ? ENOMEM : 0;
+}
+}
+#endif
+
+void* operator new(size_t size)
+{
+#ifndef __GLIBC__
+	/* Otherwise the call is counted by malloc(). */
+	ALLOCS++;
+#endif
+	void* p = malloc((size > 0) ? size : 1);
+	if (p == 0)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t size) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p, size_t size) noexcept
+{
+	free(p);
+}
+#endif
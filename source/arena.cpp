@@ -0,0 +1,60 @@
+#include <common.h>
+#include <arena.h>
+
+CArena::CArena()
+{
+	base = 0;
+	SIZE = 0;
+	used = 0;
+}
+
+CArena::~CArena()
+{
+	free(base);
+}
+
+size_t CArena::align(size_t bytes)
+{
+	return (bytes+ARENA_ALIGN-1)/ARENA_ALIGN*ARENA_ALIGN;
+}
+
+void CArena::reserve(size_t bytes)
+{
+	free(base);
+	SIZE = align(bytes);
+	used = 0;
+	base = 0;
+	if (SIZE == 0)
+		return;
+	base = (char*)aligned_alloc(ARENA_ALIGN, SIZE);
+	if (base == 0) {
+		printf("[EE]: Can't allocate %lu bytes for the model!\n", (unsigned long)SIZE);
+		exit(-1);
+	}
+}
+
+void CArena::reset()
+{
+	used = 0;
+}
+
+void* CArena::alloc(size_t bytes)
+{
+	size_t n = align(bytes);
+	assert(used+n <= SIZE);
+	void* p = base+used;
+	used += n;
+	return p;
+}
+
+void CArena::swap(CArena& arena)
+{
+	char* b = base; base = arena.base; arena.base = b;
+	size_t s = SIZE; SIZE = arena.SIZE; arena.SIZE = s;
+	s = used; used = arena.used; arena.used = s;
+}
+
+size_t CArena::size() const
+{
+	return SIZE;
+}
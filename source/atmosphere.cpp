@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include <math.h>
+#include <vector>
 #include <atmosphere.h>
 
 /* Параметры атмосферы на среднем уровне моря */
@@ -290,26 +291,57 @@ double sa_MolarTemperature(double H) {
 	return T0 + betha*(h-h0);
 }
 
+/* Нижние границы слоёв по табл. 5, геопотенциальная высота [м] */
+static const double PRESSURE_H0[12] = {-2000., 0., 11000., 20000., 32000., 47000.,
+	51000., 71000., 85000., 94000., 102450., 117777.};
+
+/*
+ * Давление от нижней границы слоя H0 с давлением P0 до высоты Hgeo
+ * Hgeo - геопотенциальная высота [м]
+ * return - давление на геопотенциальной высоте Hgeo
+*/
+static double layer_pressure(double Hgeo, double P0, double H0, double Tm0, double BethaM) {
+	if (BethaM !=0.)
+		return pow(10., log10(P0) - (gc/(BethaM*R)) * log10((Tm0+BethaM*(Hgeo-H0))/Tm0));
+	else
+		return pow(10., log10(P0) - (0.434294*gc/(sa_Temperature((6356767.*Hgeo)/(6356767.-Hgeo))*R)) * (Hgeo-H0));
+}
+
+/*
+ * Давления на нижних границах слоёв. Вычисляются один раз при запуске
+ * программы последовательно от слоя к слою, теми же операциями, что и
+ * прежний рекурсивный спуск к высоте минус 2000 м.
+*/
+static struct pressure_base_t {
+	double P0[12];
+	pressure_base_t() {
+		double H0, Tm0, BethaM;
+		P0[0] = 127774.;
+		for (int k=1; k<12; k++) {
+			standardAtmosphereRanges(PRESSURE_H0[k], &H0, &Tm0, &BethaM);
+			assert(H0 == PRESSURE_H0[k-1]);
+			P0[k] = layer_pressure(PRESSURE_H0[k], P0[k-1], H0, Tm0, BethaM);
+		}
+	}
+} PRESSURE_BASE;
+
 /*
- * Рекурсивное вычисление давления
+ * Вычисление давления от нижней границы слоя
  * Hgeo - геопотенциальная высота [м]
  * return - давление на геопотенциальной высоте Hgeo
 */
 static double static_pressure_calc(double Hgeo) {
 	double H0, Tm0, BethaM;
+	int k;
 	
 	// Высоты от минус 2000 до 120 000 м
-	
-	// База рекурсии
 	if (Hgeo == -2000.)
-		return 127774.;
+		return PRESSURE_BASE.P0[0];
 	// Опорные параметры стандартной атмосферы по табл. 5
 	standardAtmosphereRanges(Hgeo, &H0, &Tm0, &BethaM);
-	
-	if (BethaM !=0.)
-		return pow(10., log10(static_pressure_calc(H0)) - (gc/(BethaM*R)) * log10((Tm0+BethaM*(Hgeo-H0))/Tm0));
-	else
-		return pow(10., log10(static_pressure_calc(H0)) - (0.434294*gc/(sa_Temperature((6356767.*Hgeo)/(6356767.-Hgeo))*R)) * (Hgeo-H0));
+	for (k=0; PRESSURE_H0[k] != H0; k++)
+		assert(k < 11);
+	return layer_pressure(Hgeo, PRESSURE_BASE.P0[k], H0, Tm0, BethaM);
 }
 
 /*
@@ -526,6 +558,176 @@ double sa_AirPartsShockFrequency(double H) {
 	return 6.238629e6*sa_StaticPressure(H)/(sqrt(sa_Temperature(H)*sa_MolarMass(H)));
 }
 
+/*
+ * Параметры атмосферы для газодинамического расчёта (BCA)
+ *
+ * Слои по геопотенциальной высоте: нижняя граница [м], температура [К],
+ * градиент температуры [К/м], давление [Па].
+*/
+static const double BCA_LAYERS[13][4] = {
+	{-2000.,	301.15,	-0.0065,	127774.},
+	{-0.,		288.15,	-0.0065,	101325.},
+	{11000.,	216.65,	0.0,		22632.},
+	{20000.,	216.65,	0.001,		5474.87},
+	{32000.,	228.65,	0.0028,		868.014},
+	{47000.,	270.65,	0.0,		110.906},
+	{51000.,	270.65,	-0.0028,	66.9384},
+	{71000.,	214.65,	-0.002,		3.95639},
+	{80000.,	196.65,	-0.002,		0.886272},
+	{85000.,	186.65,	0.,		0.363403},
+	{94000.,	186.65,	0.003,		0.0699754},
+	{102450.,	212.,	0.011,		0.0164122},
+	{117777.,	380.6,	0.011,		0.00266618}
+};
+static const double BCA_G0 = 9.80665; // ускорение свободного падения [м/с^2]
+static const double BCA_R1 = 8314.32; // универсальная газовая постоянная
+static const double BCA_RE = 6356766.0; // радиус Земли [м]
+static const double BCA_HM1 = 28.96442; // молярная масса воздуха до 85 000 м
+
+/*
+ * Постоянные слоёв, вычисляемые при запуске программы: газовая постоянная
+ * и показатели степени барометрической формулы до высоты 85 000 м, где
+ * молярная масса воздуха постоянна.
+*/
+static struct bca_const_t {
+	double RT;
+	double E[13];
+	bca_const_t() {
+		RT = BCA_R1/BCA_HM1;
+		for (int i=0; i<13; i++)
+			E[i] = (BCA_LAYERS[i][2] != 0.) ? BCA_G0/(BCA_LAYERS[i][2]*RT) : 0.;
+	}
+} BCA_CONST;
+
+/*
+ * Плотная таблица BCA: значения T, P, rho, a в узлах равномерной сетки по
+ * геопотенциальной высоте, между узлами - линейная интерполяция. Давление
+ * в табл. BCA_LAYERS разрывно на границах слоёв, поэтому интервалы сетки,
+ * содержащие границу слоя, вычисляются по слоям.
+*/
+static struct {
+	double H0;
+	double H1;
+	double inv;
+	int count;
+	std::vector<double> v;
+	std::vector<char> exact;
+} BCA_DENSE = {0., 0., 0., 0};
+
+/* Расчёт по слоям, H1 - геопотенциальная высота [м] */
+static void bca_layers(double H1, double* TB, double* PHB, double* ROHB, double* F) {
+	const double (*A)[4] = BCA_LAYERS;
+	double HM;
+	if (H1 <= 85000.0)
+		HM=28.96442;
+	else if (H1 <= 94000.0)
+		HM=28.96442-0.00942*(H1-85000.0)/9000.0;
+	else if (H1 <= 102450.0)
+		HM=28.955-1.109*(H1-94000.0)/8450.0;
+	else
+		HM=27.846-2.396*(H1-102450.0)/15327.0;
+	double RT=(H1 <= 85000.0) ? BCA_CONST.RT : BCA_R1/HM;
+	int i;
+	for (i = 1; (A[i][0] <= H1) && (i<12); i++);
+	double T=A[i-1][1]+(A[i][1]-A[i-1][1])*(H1-A[i-1][0])/(A[i][0]-A[i-1][0]);
+	*TB=T*HM/BCA_HM1;
+	*F=20.046796*pow(*TB,0.5);
+	if (A[i-1][2] != 0.0) {
+		double E = (H1 <= 85000.0) ? BCA_CONST.E[i-1] : BCA_G0/(A[i-1][2]*RT);
+		if (A[i-1][2] > 0)
+			*PHB=A[i-1][3]/pow(1+A[i-1][2]*(H1-A[i-1][0])/A[i-1][1], E);
+		else
+			*PHB=A[i-1][3]*pow(1+A[i-1][2]*(H1-A[i-1][0])/A[i-1][1], -E);
+	} else
+		*PHB=A[i-1][3]*exp(-BCA_G0*(H1-A[i-1][0])/(RT*A[i-1][1]));
+	*PHB=*PHB/BCA_G0;
+	*ROHB=*PHB/(RT*(*TB));
+}
+
+void BCA(double HB, double* TB, double* PHB, double* ROHB, double* F) {
+	double H1=BCA_RE*HB/(BCA_RE+HB);
+	if ((BCA_DENSE.count > 0) && (H1 >= BCA_DENSE.H0) && (H1 < BCA_DENSE.H1)) {
+		double x = (H1-BCA_DENSE.H0)*BCA_DENSE.inv;
+		int k = (int)x;
+		if (!BCA_DENSE.exact[k]) {
+			double w = x-k;
+			const double* v = &(BCA_DENSE.v[4*k]);
+			*TB = v[0]+(v[4]-v[0])*w;
+			*PHB = v[1]+(v[5]-v[1])*w;
+			*ROHB = v[2]+(v[6]-v[2])*w;
+			*F = v[3]+(v[7]-v[3])*w;
+			return;
+		}
+	}
+	bca_layers(H1, TB, PHB, ROHB, F);
+}
+
+void BCA(const double* HB, int n, double* TB, double* PHB, double* ROHB, double* F) {
+	const int count = BCA_DENSE.count;
+	const double H0 = BCA_DENSE.H0;
+	const double Hend = BCA_DENSE.H1;
+	const double inv = BCA_DENSE.inv;
+	const double* v = (count > 0) ? &(BCA_DENSE.v[0]) : 0;
+	const char* exact = (count > 0) ? &(BCA_DENSE.exact[0]) : 0;
+	for (int k=0; k<n; k++) {
+		double H1=BCA_RE*HB[k]/(BCA_RE+HB[k]);
+		if ((count > 0) && (H1 >= H0) && (H1 < Hend)) {
+			double x = (H1-H0)*inv;
+			int j = (int)x;
+			if (!exact[j]) {
+				double w = x-j;
+				const double* vj = &(v[4*j]);
+				TB[k] = vj[0]+(vj[4]-vj[0])*w;
+				PHB[k] = vj[1]+(vj[5]-vj[1])*w;
+				ROHB[k] = vj[2]+(vj[6]-vj[2])*w;
+				F[k] = vj[3]+(vj[7]-vj[3])*w;
+				continue;
+			}
+		}
+		bca_layers(H1, &(TB[k]), &(PHB[k]), &(ROHB[k]), &(F[k]));
+	}
+}
+
+double BCA_Dense(double step, double Hmax) {
+	BCA_DENSE.count = 0;
+	BCA_DENSE.v.clear();
+	BCA_DENSE.exact.clear();
+	if (step <= 0.)
+		return 0.;
+	double H0 = BCA_RE*(-2000.)/(BCA_RE-2000.);
+	double H1 = BCA_RE*Hmax/(BCA_RE+Hmax);
+	assert(H1 > H0+step);
+	int count = (int)ceil((H1-H0)/step)+1;
+	std::vector<double> v(4*count);
+	std::vector<char> exact(count, 0);
+	for (int k=0; k<count; k++)
+		bca_layers(H0+k*step, &(v[4*k]), &(v[4*k+1]), &(v[4*k+2]), &(v[4*k+3]));
+	// Интервалы с границами слоёв, граница в узле сетки - оба соседних
+	for (int i=0; i<13; i++) {
+		int k = (int)floor((BCA_LAYERS[i][0]-H0)/step);
+		for (int j=k-1; j<=k; j++)
+			if ((j >= 0) && (j < count))
+				exact[j] = 1;
+	}
+	BCA_DENSE.H0 = H0;
+	BCA_DENSE.H1 = H0+(count-1)*step;
+	BCA_DENSE.inv = 1./step;
+	BCA_DENSE.v.swap(v);
+	BCA_DENSE.exact.swap(exact);
+	BCA_DENSE.count = count;
+
+	// Оценка погрешности: середины и четверти интервалов
+	double err = 0.;
+	for (int k=0; k<4*(count-1); k++) {
+		double H = H0+(k+0.5)*step/4., e[4], d[4];
+		bca_layers(H, &(e[0]), &(e[1]), &(e[2]), &(e[3]));
+		BCA(BCA_RE*H/(BCA_RE-H), &(d[0]), &(d[1]), &(d[2]), &(d[3]));
+		for (int j=0; j<4; j++)
+			err = fmax(err, fabs(d[j]-e[j])/fabs(e[j]));
+	}
+	return err;
+}
+
 /*
  * Тест
 */
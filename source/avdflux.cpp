@@ -0,0 +1,255 @@
+#include <avdflux.h>
+
+/** Adiabatic index of the free stream. */
+#define AVD_XAP	(1.4)
+
+/** Constants of the Avduevsky correlations, computed once. */
+static const struct avd_const_t {
+	double XK;	/* XAP/(XAP-1) */
+	double XK2;	/* 2*XAP/(XAP-1) */
+	double XI;	/* 1/(XAP-1) */
+	double XH;	/* (XAP-1)/2 */
+	double XP;	/* (XAP+1)/2 */
+	double XR;	/* (XAP-1)/XAP */
+	double XF2;	/* ((XAP+1)/(XAP-1))^0.4 */
+	double CX1, CX2, CX3, CX4, CX5;
+	avd_const_t()
+	{
+		const double XAP = AVD_XAP;
+		XK = XAP/(XAP-1.);
+		XK2 = 2.*XAP/(XAP-1.);
+		XI = 1./(XAP-1.);
+		XH = (XAP-1.)/2.;
+		XP = (XAP+1.)/2.;
+		XR = (XAP-1.)/XAP;
+		XF2 = pow(((XAP+1.)/(XAP-1.)), 0.4);
+		CX1 = pow(((XAP+1)/2.), ((XAP+1.)/(XAP-1.)));
+		CX2 = pow((2./(XAP-1.)), (1./(XAP-1.)));
+		CX3 = pow(6, 0.25);
+		CX4 = pow(1.2, 6)*pow(5, 2.5);
+		CX5 = 1.0/729.0/0.85;
+	}
+} AVD_C;
+
+/** Part of the computation that depends on the free stream only. */
+typedef struct {
+	double TB, ROH, VT, M;
+	double OI, AM1, P11, P0;
+	/* M > 2 */
+	double F3, F3L, ALT, ALL;
+} avd_stream_t;
+
+static void avd_stream(avd_stream_t* s, double TB, double ROH, double VT, double M)
+{
+	const double XAP = AVD_XAP;
+	s->TB = TB;
+	s->ROH = ROH;
+	s->VT = VT;
+	s->M = M;
+	s->OI = 0.24*TB+VT*VT/8370.0;
+	double AM1 = M*M;
+	double AM = M;
+	s->AM1 = AM1;
+	double C3 = pow(AM1, AVD_C.XK)/pow((AVD_C.XK2*AM1-1.), AVD_C.XI);
+	s->P11 = AVD_C.CX1*AVD_C.CX2*C3;
+	double PP = ROH*28.3*TB*9.80665*0.0001;
+	s->P0 = s->P11*PP;
+	if (M <= 2.0)
+		return;
+	C3 = 1./pow((1.+AVD_C.XH*AM1), 0.6);
+	double C1 = pow(((1.+AVD_C.XH*AM1)/(AVD_C.XP*AM1)), 0.4);
+	double C2 = 1./pow((XAP*AM1), 0.2);
+	s->F3 = pow(s->P11, 0.8)*C1*C2*C3;
+	s->F3L = pow((AVD_C.CX4*pow(AM, 7.)/pow((7.*AM1-1.), 2.5)), 0.5)*pow(((1.+0.2*AM1)/1.2/AM1), 0.25)/AM;
+	s->ALT = 0.00243*pow(VT, 1.2)*pow(ROH, 0.8);
+	s->ALL = 1.08E-5*pow(VT, 1.5)*sqrt(ROH);
+}
+
+/* Reduction of the heat transfer coefficient by the blowing of the ablating surface */
+static double avd_blowing_factor(double GK)
+{
+	return pow((0.5+sqrt(0.25+GK*AVD_C.CX5)), 0.333)-pow((sqrt(0.25+GK*AVD_C.CX5)-0.5), 0.333);
+}
+
+/* P = P/P0, O - surface inclination angle, deg */
+static void avd_point(const avd_stream_t& s, avd_batch_t* b, int k)
+{
+	const double TB = s.TB, ROH = s.ROH, VT = s.VT, AM = s.M, AM1 = s.AM1, OI = s.OI;
+	const double P = b->P[k], TW = b->TW[k], X = b->X[k], O = b->O[k], XEF = b->XEF[k];
+	double ALC0, WI, EI;
+	double SIB = 0., XAP1 = 0., V0 = 0., F1 = 0., F2 = 0., F3 = 0., DK = 0., EK = 0.;
+	if (AM <= 2.0) {
+		ALC0=0.0007*pow(ROH*VT, 0.8)/pow(X, 0.2)*pow(((TB+TW)/(2.0*TB)), 2.137)*pow(0.24*TB, 0.137);
+		WI=0.24*TW;
+		EI=OI;
+	} else {
+		F3=s.F3;
+		F1=1.+0.137*sin(1.57*(1.-(TW-273.)/1000.));
+		if (TW <= 1000.0)
+			WI=0.245*TW;
+		else if (TW <= 2500.0)
+			WI=245.+0.310*(TW-1000.);
+		else
+			WI=TW*TW/8800./pow((1.+0.05*log10(s.P0)), 2);
+		double XM=3.*pow((24./O+4.), (3.-9./AM));
+		double XAP0=1.23;
+		XAP1=XAP0;
+		V0=1.15*(cos(O*0.0174))-0.055*pow((O/10.), 0.97)/AM;
+		double X1=(X/b->Rad[k]-1.57*(1.0-O/90.))*cos(O*0.0174);
+		double OM;
+		if (V0 < 1.0)
+			V0=1.0;
+		do {
+			double B0;
+			OM=1./(pow(P, ((XAP1-1.)/XAP1)))-1.;
+			double C1=1.-AVD_C.XH*AM1*(1.-pow(V0, 2));
+			double C2=AVD_C.XH*AM1*pow(V0, 2);
+			double OMM=C2/C1/OM;
+			if (X1 < XM)
+				B0=1.0;
+			else
+				B0=(X1-XM)/2./XM*(OMM-1.)+1.;
+
+			if (fabs(B0) > fabs(OMM))
+				B0=OMM;
+			double B00=(1.-WI/OI)/(1.+WI/OI);
+			if (B0*OM > B00)
+				SIB=OI/4.*((B0*OM+1.)/B0/OM)*pow((1.-WI/OI), 2)+WI;
+			else
+				SIB=OI/(1.+OM*B0);
+			if (SIB > 500.0)
+				XAP0=1.23-96./SIB+6E+4/pow(SIB, 2);
+			else
+				XAP0=1.4-0.12*SIB/500.;
+			XAP1=XAP0;
+		} while (fabs(XAP0-XAP1) >= 0.01);
+
+		F2=AVD_C.XF2*pow((1.-pow(P, AVD_C.XR)), 0.4)*pow(P, 0.8)*pow((OI/SIB), 0.6);
+		DK=0.78*pow(SIB, 0.05);
+		if (VT <= 1000.0)
+			DK=1.0;
+		double EKM=1.11+0.0055*O;
+		EK=(X1-XM)/2./XM*(EKM-1.)+1.;
+		if (EK > EKM)
+			EK=EKM;
+		if (X1 <= XM)
+			EK=1.0;
+		EI=OI*(1.+0.89*OM)/(1.+OM);
+		ALC0=s.ALT*F1*F2*F3*DK*EK/XEF;
+		if (b->LT[k] != 0) {
+			double F1L=1.0;
+			if (SIB < 1800.0)
+				F1L=1.45/pow(WI, 0.06);
+			double F2L=AVD_C.CX3*pow((1.-pow(P, 0.288)), 0.25)*pow(P, 0.5);
+			if (SIB >= 1800.0)
+				DK=6.4/pow(SIB, 0.25);
+			else
+				DK=3.42/pow(SIB, 0.19);
+			ALC0=s.ALL*F1L*F2L*s.F3L/XEF*EK*DK;
+		}
+	}
+	double ALC=ALC0;
+	double QW, ALC1 = ALC;
+	if ((b->ICC[k] == 0) || (TW < 1000.0)) {
+		QW=ALC*(EI-WI);
+	} else {
+		const double GK = b->GK[k];
+		ALC1=ALC*avd_blowing_factor(GK);
+		QW=1.3*ALC1*(EI-WI);
+	}
+	b->I0[k] = OI*4186.8;
+	b->IW[k] = WI*4186.8;
+	b->IE[k] = EI*4186.8;
+	b->ISTAR[k] = SIB*4186.8;
+	b->ALC[k] = ALC;
+	b->ALC1[k] = ALC1;
+	b->QCONV[k] = QW*4186.8;
+	b->XAP1[k] = XAP1;
+	b->P0[k] = s.P0;
+	b->P1[k] = P*s.P0;
+	b->V0[k] = V0;
+	b->F1[k] = F1;
+	b->F2[k] = F2;
+	b->F3[k] = F3;
+	b->KDIS[k] = DK;
+	b->KENTH[k] = EK;
+}
+
+void avd_resize(avd_batch_t* batch, int count)
+{
+	vector<double>* in[] = {&batch->TB, &batch->ROH, &batch->V, &batch->M, &batch->P, &batch->TW,
+		&batch->X, &batch->O, &batch->Rad, &batch->XEF, &batch->GK,
+		&batch->I0, &batch->IW, &batch->IE, &batch->ISTAR, &batch->ALC, &batch->ALC1, &batch->QCONV, &batch->XAP1,
+		&batch->P0, &batch->P1, &batch->V0, &batch->F1, &batch->F2, &batch->F3, &batch->KDIS, &batch->KENTH};
+	assert(count >= 0);
+	for (size_t i=0; i<sizeof(in)/sizeof(in[0]); i++)
+		in[i]->resize(count);
+	batch->LT.resize(count);
+	batch->ICC.resize(count);
+	batch->count = count;
+}
+
+void avd_set(avd_batch_t* batch, int k, double TB, double ROH, double V, double M, double P, double TW,
+	double X, double O, double Rad, double XEF, int LT, int ICC, double GK)
+{
+	assert((k >= 0) && (k < batch->count));
+	batch->TB[k] = TB;
+	batch->ROH[k] = ROH;
+	batch->V[k] = V;
+	batch->M[k] = M;
+	batch->P[k] = P;
+	batch->TW[k] = TW;
+	batch->X[k] = X;
+	batch->O[k] = O;
+	batch->Rad[k] = Rad;
+	batch->XEF[k] = XEF;
+	batch->LT[k] = LT;
+	batch->ICC[k] = ICC;
+	batch->GK[k] = GK;
+}
+
+void avd_flux(avd_batch_t* batch)
+{
+	avd_stream_t s;
+	for (int k=0; k<batch->count; k++) {
+		/* Free stream part is shared by the neighbouring points of one step. */
+		if ((k == 0) || (batch->TB[k] != s.TB) || (batch->ROH[k] != s.ROH) ||
+			(batch->V[k] != s.VT) || (batch->M[k] != s.M))
+			avd_stream(&s, batch->TB[k], batch->ROH[k], batch->V[k], batch->M[k]);
+		avd_point(s, batch, k);
+	}
+}
+
+avd_t avd_get(const avd_batch_t& batch, int k)
+{
+	avd_t avd;
+	assert((k >= 0) && (k < batch.count));
+	avd.I0 = batch.I0[k];
+	avd.IW = batch.IW[k];
+	avd.IE = batch.IE[k];
+	avd.ISTAR = batch.ISTAR[k];
+	avd.ALC = batch.ALC[k];
+	avd.ALC1 = batch.ALC1[k];
+	avd.QCONV = batch.QCONV[k];
+	avd.XAP1 = batch.XAP1[k];
+	avd.P0 = batch.P0[k];
+	avd.P1 = batch.P1[k];
+	avd.V0 = batch.V0[k];
+	avd.F1 = batch.F1[k];
+	avd.F2 = batch.F2[k];
+	avd.F3 = batch.F3[k];
+	avd.KDIS = batch.KDIS[k];
+	avd.KENTH = batch.KENTH[k];
+	return avd;
+}
+
+void avd_blowing(avd_t* avd, int ICC, double TW, double GK)
+{
+	if ((ICC == 0) || (TW < 1000.0)) {
+		avd->ALC1 = avd->ALC;
+		avd->QCONV = avd->ALC*(avd->IE-avd->IW);
+	} else {
+		avd->ALC1 = avd->ALC*avd_blowing_factor(GK);
+		avd->QCONV = 1.3*avd->ALC1*(avd->IE-avd->IW);
+	}
+}
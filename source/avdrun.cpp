@@ -0,0 +1,112 @@
+#include <avdrun.h>
+#include <cstring>
+
+/** Время между перестройками сетки, с. */
+#define REMESH_PERIOD	(1.)
+
+int configure(AVDSolver* solver, thm_t* thm, const options_t& opt, const print_t& prn)
+{
+	if (opt.SCHEME != SCHEME_EULER)
+		solver->setScheme(opt.SCHEME, opt.TOL, (opt.TIMESTEP_MAX > 0.) ? opt.TIMESTEP_MAX : prn.print_interval);
+	else if (opt.TIMESTEP_MAX > 0.)
+		solver->setScheme(opt.SCHEME, opt.TOL, opt.TIMESTEP_MAX);
+	if (opt.PICARD_TOL > 0.)
+		solver->setPicard(PICARD_ITERS_STD, opt.PICARD_TOL);
+	if (opt.REMESH_DT > 0.) {
+		/*
+		 * Ячейки у поверхности измельчаются до 1/8 исходной, в глубине укрупняются до 4 исходных.
+		 * Ячеек не больше, чем в исходной сетке: измельчение у поверхности оплачивается
+		 * укрупнением в глубине.
+		 */
+		remesh_t rp;
+		rp.WMIN = thm->PrimaryLeftCellSize/8.;
+		rp.WMAX = thm->PrimaryLeftCellSize*4.;
+		rp.DT_REFINE = opt.REMESH_DT;
+		rp.DT_COARSEN = opt.REMESH_DT/2.;
+		rp.NMAX = thm->lcnum-thm->fcnum+1;
+		rp.PERIOD = REMESH_PERIOD;
+		solver->setRemesh(rp);
+	}
+	solver->setMoving(opt.MOVING);
+	solver->setHeatFlux(opt.FLUX);
+	for (size_t k=0; k<opt.BC_NAMES.size(); k++) {
+		int res = solver->setTimeChangeCoefs(opt.BC_NAMES[k], &(opt.BC_COEFS[k]));
+		if (res == -2) {
+			printf("[EE]: Unknown boundary parameter %s\n", opt.BC_NAMES[k]);
+			return NULL_VALUE;
+		} else if (res != SUCCESS) {
+			printf("[EE]: Bad table of boundary parameter %s\n", opt.BC_NAMES[k]);
+			return NULL_VALUE;
+		}
+	}
+	if (opt.MEMO_DT > 0.)
+		solver->setMemo(opt.MEMO_DT, opt.MEMO_DTW);
+	return SUCCESS;
+}
+
+void print_header(FILE* f, const vector<res_column_t>& columns)
+{
+	fprintf(f, "\n--- RESULTS ---\n\n");
+	for (size_t c=0; c<columns.size(); c++)
+		fprintf(f, "%s\t", columns[c].NAME);
+	fprintf(f, "\n");
+}
+
+vector<res_column_t> result_columns(thm_t* thm, const print_t& prn, CADISolver* adi)
+{
+	static const res_column_t COLUMNS[] = {{"TIME", "%7.2lf"}, {"QCONV", "%7.1lf"}, {"DY", "%7.3lf"}, {"T1", "%7.1lf"},
+		{"T2", "%7.1lf"}, {"P", "%7.4lf"}, {"ALC", "%7.4lf"}, {"IE", "%7.1lf"}, {"IW", "%7.1lf"}, {"FI", "%7.2lf"},
+		{"ALF", "%7.2lf"}, {"H", "%7.2lf"}, {"V", "%7.1lf"}, {"MACH", "%5.2lf"}, {"XEF", "%7.5lf"}};
+	vector<res_column_t> columns;
+	res_column_t column;
+	for (size_t c=0; c<sizeof(COLUMNS)/sizeof(COLUMNS[0]); c++) {
+		/* Заголовок шириной в значение столбца. */
+		int width = atoi(COLUMNS[c].FORMAT+1);
+		snprintf(column.NAME, RES_NAME_LEN, "%*.*s", width, width, COLUMNS[c].NAME);
+		strcpy(column.FORMAT, COLUMNS[c].FORMAT);
+		columns.push_back(column);
+	}
+	strcpy(column.FORMAT, "%7.1lf");
+	for (int i=0; i<prn.PRINT_CELLS_NUM; i++) {
+		snprintf(column.NAME, RES_NAME_LEN, "%5.5s%6.1lf", "CELL", thm->T[prn.PRINT_CELLS[i]]);
+		columns.push_back(column);
+	}
+	for (int k=0; (adi != 0) && (k<adi->count()); k++) {
+		snprintf(column.NAME, RES_NAME_LEN, "%2.2s%5.3lf", "TW", adi->x(k));
+		columns.push_back(column);
+	}
+	return columns;
+}
+
+void result_row(double* row, const avdsolver_t& info, thm_t* thm, const print_t& prn, CADISolver* adi)
+{
+	int n = 0;
+	row[n++] = info.time;
+	row[n++] = info.avd.QCONV/4186.8;
+	row[n++] = thm->LDEL*1000.;
+	row[n++] = thm->TWL;
+	row[n++] = thm->TWR;
+	row[n++] = info.avd.P1;
+	row[n++] = info.avd.ALC;
+	row[n++] = info.avd.IE/4186.8;
+	row[n++] = info.avd.IW/4186.8;
+	row[n++] = info.phi;
+	row[n++] = info.al;
+	row[n++] = info.H/1000.;
+	row[n++] = info.V;
+	row[n++] = info.mach;
+	row[n++] = info.XEF;
+	for (int i=0; i<prn.PRINT_CELLS_NUM; i++)
+		row[n++] = thm->cellT(prn.PRINT_CELLS[i]-1);
+	for (int k=0; (adi != 0) && (k<adi->count()); k++)
+		row[n++] = adi->station(k)->TWL;
+}
+
+void print_row(FILE* f, const vector<res_column_t>& columns, const double* row)
+{
+	for (size_t c=0; c<columns.size(); c++) {
+		fprintf(f, columns[c].FORMAT, row[c]);
+		fprintf(f, "\t");
+	}
+	fprintf(f, "\n");
+}
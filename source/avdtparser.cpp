@@ -1,92 +1,192 @@
 #include <avdtparser.h>
 #include <material.h>
 
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**      . */
+#define TOKEN_MAX_LEN		(128)
+
 /**
- *    
- * @param f -    
- * @param fmt -  .
- * @param par -   ,     
- * @param isNewStr -   .
- * @return  
+ * @brief    .
+ * @details         : read()
+ *       ,  
+ *  ,       , 
+ *    . ,    ,  
+ *     ,   sscanf().
  */
-#include <string>
-using namespace std;
-static char str[STRING_MAX_LEN];
-string format;
-CUserMaterial* m[MATERIALS_MAX_NUM];
-static int read(FILE* f, const char* fmt, void* par, bool isNewStr = false)
-{
-	if (isNewStr) {
-		format = "";
-		char* res;
-		if (feof(f))
-			return -1;
-		res = fgets(str, STRING_MAX_LEN, f);
-		if (res == 0)
-			return -1;
+class CTokenizer {
+	/**    . */
+	const char* data;
+	/**  . */
+	size_t size;
+	/**      . */
+	const char* pos;
+	const char* eol;
+	/**   . */
+	const char* next;
+	CTokenizer(const CTokenizer&);
+	CTokenizer& operator=(const CTokenizer&);
+	/**
+	 * @brief     .
+	 * @param token -   TOKEN_MAX_LEN  ().
+	 * @param isNewStr -   .
+	 * @return  , 0 -  .
+	 */
+	size_t token(char* token, bool isNewStr)
+	{
+		if (isNewStr) {
+			if (next >= data+size) {
+				pos = eol;
+				return 0;
+			}
+			pos = next;
+			eol = (const char*)memchr(pos, '\n', data+size-pos);
+			if (eol == 0)
+				eol = data+size;
+			next = (eol < data+size) ? eol+1 : eol;
+		}
+		while ((pos < eol) && isspace((unsigned char)*pos))
+			pos++;
+		size_t len = 0;
+		while ((pos+len < eol) && (len < TOKEN_MAX_LEN-1) && !isspace((unsigned char)pos[len]))
+			len++;
+		memcpy(token, pos, len);
+		token[len] = 0;
+		return len;
 	}
-	string tmp = format + "%";
-	tmp += fmt;
-	int r = sscanf(str, tmp.c_str(), par);
-	format +="%*";
-	format += fmt;
-	return r;
-}
+public:
+	/**
+	 * @brief   .
+	 * @param filename -  .
+	 */
+	CTokenizer(const char* filename) : data(0), size(0)
+	{
+		struct stat st;
+		int fd = open(filename, O_RDONLY);
+		if ((fd < 0) || (fstat(fd, &st) != 0)) {
+			printf("FILE NOT FOUND: %s\n", filename);
+			system("pause");
+			exit(-1);
+		}
+		size = (size_t)st.st_size;
+		if (size > 0) {
+			void* map = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (map == MAP_FAILED) {
+				printf("[EE]: Can't map file %s\n", filename);
+				exit(-1);
+			}
+			data = (const char*)map;
+		}
+		close(fd);
+		pos = eol = next = data;
+	}
+	~CTokenizer()
+	{
+		if (size > 0)
+			munmap((void*)data, size);
+	}
+	/**
+	 * @brief   .
+	 * @param par -   ,     .
+	 * @param isNewStr -   .
+	 * @return   .
+	 */
+	int read(int* par, bool isNewStr = false)
+	{
+		char buf[TOKEN_MAX_LEN];
+		char* end;
+		if (token(buf, isNewStr) == 0)
+			return 0;
+		long v = strtol(buf, &end, 10);
+		if (end == buf) {
+			pos = eol;
+			return 0;
+		}
+		pos += end-buf;
+		*par = (int)v;
+		return 1;
+	}
+	/**
+	 * @brief   .
+	 * @param par -   ,     .
+	 * @param isNewStr -   .
+	 * @return   .
+	 */
+	int read(double* par, bool isNewStr = false)
+	{
+		char buf[TOKEN_MAX_LEN];
+		char* end;
+		if (token(buf, isNewStr) == 0)
+			return 0;
+		double v = strtod(buf, &end);
+		if (end == buf) {
+			pos = eol;
+			return 0;
+		}
+		pos += end-buf;
+		*par = v;
+		return 1;
+	}
+};
+
 trm_t* trm_parse(const char* filename, FILE* device)
 {
 	trm_t* trm = new trm_t;
-	FILE* ftr = fopen(filename, "rt");
-	if (ftr == 0) {
-		printf("FILE NOT FOUND: %s\n", filename);
-		system("pause");
-		exit(-1);
-	}
+	CTokenizer ftr(filename);
 	/* ---      --- */
-	read(ftr, "d", &(trm->POINTS_NUM), true); fprintf(device, "%d\t", trm->POINTS_NUM);
+	ftr.read(&(trm->POINTS_NUM), true); fprintf(device, "%d\t", trm->POINTS_NUM);
 	if (trm->POINTS_NUM <= 0) {
 		printf("[EE]: Incorrect number of trajectory points: %d\n", trm->POINTS_NUM);
 		exit(-1);
 	}
-	if (trm->POINTS_NUM >= TRAJECTORY_MAX_LEN) {
-		printf("[EE]: Number of trajectory points [%d] exceed the up limit [%d]!\n", trm->POINTS_NUM, TRAJECTORY_MAX_LEN);
-		exit(-1);
-	}
-	read(ftr, "lf", &(trm->BEGIN_TIME)); fprintf(device, "%8.2lf\t", trm->BEGIN_TIME);
-	read(ftr, "lf", &(trm->END_TIME)); fprintf(device, "%8.2lf\t", trm->END_TIME);
+	ftr.read(&(trm->BEGIN_TIME)); fprintf(device, "%8.2lf\t", trm->BEGIN_TIME);
+	ftr.read(&(trm->END_TIME)); fprintf(device, "%8.2lf\t", trm->END_TIME);
 	if (trm->BEGIN_TIME >= trm->END_TIME) {
 		printf("[EE]: BEGIN calculation time [%lf] more than END time [%lf]!\n", trm->BEGIN_TIME, trm->END_TIME);
 		exit(-1);
 	}
-	read(ftr, "lf", &(trm->THETA)); fprintf(device, "%8.2lf\n", trm->THETA);
+	ftr.read(&(trm->THETA)); fprintf(device, "%8.2lf\n", trm->THETA);
 	if ((trm->THETA < -90.) || (trm->THETA > 90.)) {
 		printf("[EE]: THETA value [%lf] is out of range!\n", trm->THETA);
 		exit(-1);
 	}
-	double time[TRAJECTORY_MAX_LEN]; /*    . */
+	vector<double> time(trm->POINTS_NUM); /*    . */
 	/*    . */
 	for (int i=0; i<trm->POINTS_NUM;) {
 		bool r = true;
 		for (int j=0; ((i<trm->POINTS_NUM) && (j < 6)); i++, j++) {
-			read(ftr, "lf", &(time[i]), r);
+			ftr.read(&(time[i]), r);
 			r = false;
 			fprintf(device, "%11.5lf\t", time[i]);
 		}
 		fprintf(device, "\n");
 	}
+	/*       . */
+	const int points = trm->POINTS_NUM;
+	const double* times = &(time[0]);
+	trm->V.create(&points, &times);
+	trm->H.create(&points, &times);
+	trm->AL.create(&points, &times);
+	trm->PHI.create(&points, &times);
 	/*   . */
 	fprintf(device, "--- VELOCITY ---\n");
 	for (int i=0; i<trm->POINTS_NUM; ) {
 		double V;
 		bool r = true;
 		for (int j=0; ((i<trm->POINTS_NUM) && (j < 6)); i++, j++) {
-			read(ftr, "lf", &(V), r);
+			ftr.read(&(V), r);
 			r = false;
 			if (V < 0.) {
 				printf("[EE]: VELOCITY value [%lf] is out of range\n", V);
 				exit(-1);
 			}
 			fprintf(device, "%11.5lf\t", V);
-			trm->V.add(time[i], V);
+			trm->V.set(&i, V);
 		}
 		fprintf(device, "\n");
 	}
@@ -97,14 +197,14 @@ trm_t* trm_parse(const char* filename, FILE* device)
 		double H;
 		bool r = true;
 		for (int j=0; ((i<trm->POINTS_NUM) && (j < 6)); i++, j++) {
-			read(ftr, "lf", &(H), r);
+			ftr.read(&(H), r);
 			r = false;
 			if (H < 0.) {
 				printf("[EE]: HEIGHT value [%lf] is out of range\n", H);
 				exit(-1);
 			}
 			fprintf(device, "%11.5lf\t", H);
-			trm->H.add(time[i], H);
+			trm->H.set(&i, H);
 		}
 		fprintf(device, "\n");
 	}
@@ -114,14 +214,14 @@ trm_t* trm_parse(const char* filename, FILE* device)
 		double AL;
 		bool r = true;
 		for (int j=0; ((i<trm->POINTS_NUM) && (j < 6)); i++, j++) {
-			read(ftr, "lf", &(AL), r);
+			ftr.read(&(AL), r);
 			r = false;
 			if ((AL < -75.) || (AL > 75.)) {
 				printf("[EE]: ANGLE of ATTACK value [%lf] is out of range\n", AL);
 				exit(-1);
 			}
 			fprintf(device, "%11.5lf\t", AL);
-			trm->AL.add(time[i], AL);
+			trm->AL.set(&i, AL);
 		}
 		fprintf(device, "\n");
 	}
@@ -131,14 +231,13 @@ trm_t* trm_parse(const char* filename, FILE* device)
 		double PHI;
 		bool r = true;
 		for (int j=0; ((i<trm->POINTS_NUM) && (j < 6)); i++, j++) {
-			read(ftr, "lf", &(PHI), r);
+			ftr.read(&(PHI), r);
 			r = false;
 			fprintf(device, "%11.5lf\t", PHI);
-			trm->PHI.add(time[i], PHI);
+			trm->PHI.set(&i, PHI);
 		}
 		fprintf(device, "\n");
 	}
-	fclose(ftr);
 	return trm;
 }
 thm_t* thm_parse(const char* filename, FILE* device, CBluntedCone** BCone, gasdynamics_t* gd,  print_t* prn)
@@ -150,22 +249,17 @@ thm_t* thm_parse(const char* filename, FILE* device, CBluntedCone** BCone, gasdy
 	assert(prn != 0);
 
 	thm_t* thm = new thm_t;
-	FILE* ftps = fopen(filename, "rt");
-	if (ftps == 0) {
-		printf("FILE NOT FOUND: %s\n", filename);
-		system("pause");
-		exit(-1);
-	}
+	CTokenizer ftps(filename);
 	/* ---       --- */
 	int LAYERS; /*      . */
 	double T0; /*  . */
 	func_points_t T0_FUNC;
-	read(ftps, "d", &(LAYERS), true); fprintf(device, "LAYERS=%d\t", LAYERS);
-	assert((LAYERS > 0) && (LAYERS < LAYERS_MAX_NUM));
-	read(ftps, "lf", &(T0)); fprintf(device, "T0=%8.2lf\t", T0);
+	ftps.read(&(LAYERS), true); fprintf(device, "LAYERS=%d\t", LAYERS);
+	assert(LAYERS > 0);
+	ftps.read(&(T0)); fprintf(device, "T0=%8.2lf\t", T0);
 	assert(T0 > 0.);
-	read(ftps, "d", &(prn->PRINT_CELLS_NUM)); fprintf(device, "PRINT_CELLS_NUM=%d\t", prn->PRINT_CELLS_NUM);
-	read(ftps, "d", &(T0_FUNC.count)); fprintf(device, "T0_POINTS=%d\n", T0_FUNC.count);
+	ftps.read(&(prn->PRINT_CELLS_NUM)); fprintf(device, "PRINT_CELLS_NUM=%d\t", prn->PRINT_CELLS_NUM);
+	ftps.read(&(T0_FUNC.count)); fprintf(device, "T0_POINTS=%d\n", T0_FUNC.count);
 	/* ---    . --- */
 	if (T0_FUNC.count > 0) {
 		T0_FUNC.x = new double[T0_FUNC.count];
@@ -174,76 +268,73 @@ thm_t* thm_parse(const char* filename, FILE* device, CBluntedCone** BCone, gasdy
 		bool r = true;
 		fprintf(device, "X=\t");
 		for (int i=0; i<T0_FUNC.count; i++) {
-			read(ftps, "lf", &(T0_FUNC.x[i]), r); fprintf(device, "%5.3E ", T0_FUNC.x[i]);
+			ftps.read(&(T0_FUNC.x[i]), r); fprintf(device, "%5.3E ", T0_FUNC.x[i]);
 			r = false;
 		}
 		fprintf(device, "\nT=\t");
 		r = true;
 		for (int i=0; i<T0_FUNC.count; i++) {
-			read(ftps, "lf", &(T0_FUNC.y[i]), r); fprintf(device, "%10.4lf ", T0_FUNC.y[i]);
+			ftps.read(&(T0_FUNC.y[i]), r); fprintf(device, "%10.4lf ", T0_FUNC.y[i]);
 			r = false;
 		}
 		fprintf(device, "\n");
 	}
-	fflush(NULL);
-	int isComplexTFH[LAYERS_MAX_NUM]; /*       i- . */
+	vector<CUserMaterial*> m(LAYERS);
+	vector<int> isComplexTFH(LAYERS); /*       i- . */
 	bool r = true;
 	for (int i=0; i<LAYERS; i++) {
-		read(ftps, "d", &(isComplexTFH[i]), r);
+		ftps.read(&(isComplexTFH[i]), r);
 		r = false;
 		fprintf(device, "%d\t", isComplexTFH[i]);
 	}
 	fprintf(device, "\n");
-	fflush(NULL);
-	int AblationType[LAYERS_MAX_NUM]; /*      i- . */
+	vector<int> AblationType(LAYERS); /*      i- . */
 	r = true;
 	for (int i=0; i<LAYERS; i++) {
-		read(ftps, "d", &(AblationType[i]), r);
+		ftps.read(&(AblationType[i]), r);
 		r = false;
 		fprintf(device, "%d\t", AblationType[i]);
 	}
 	fprintf(device, "\n");
-	fflush(NULL);
 	 /* ---   . --- */
-	double LAYER_DX[LAYERS_MAX_NUM]; /*     , . */
-	double LAYER_CP[LAYERS_MAX_NUM]; /*  , /*. */
-	double LAYER_D[LAYERS_MAX_NUM]; /*  , /3 */
-	double LAYER_L[LAYERS_MAX_NUM]; /*  , /*. */
-	double LAYER_A[LAYERS_MAX_NUM]; /*     . */
-	double LAYER_B[LAYERS_MAX_NUM]; /*     . */
-	double LAYER_TU[LAYERS_MAX_NUM]; /*  , . */
-	double LAYER_EPS[LAYERS_MAX_NUM]; /*    . */
-	double LAYER_AT[LAYERS_MAX_NUM]; /*   . */
+	vector<double> LAYER_DX(LAYERS); /*     , . */
+	vector<double> LAYER_CP(LAYERS); /*  , /*. */
+	vector<double> LAYER_D(LAYERS); /*  , /3 */
+	vector<double> LAYER_L(LAYERS); /*  , /*. */
+	vector<double> LAYER_A(LAYERS); /*     . */
+	vector<double> LAYER_B(LAYERS); /*     . */
+	vector<double> LAYER_TU(LAYERS); /*  , . */
+	vector<double> LAYER_EPS(LAYERS); /*    . */
+	vector<double> LAYER_AT(LAYERS); /*   . */
 	fprintf(device, "%10.10s\t%8.8s\t%8.8s\t%8.8s\t%8.8s\t%8.8s\t%8.8s\t%8.8s\t%8.8s\n", "DX", "CP", "DENS", "L", "A", "B", "Tdestr", "EPS", "AT");
 	for (int i=0; i<LAYERS; i++) {
-		read(ftps, "lf", &(LAYER_DX[i]), true); fprintf(device, "%5.3E\t", LAYER_DX[i]);
-		read(ftps, "lf", &(LAYER_CP[i])); fprintf(device, "%8.2lf\t", LAYER_CP[i]);
-		read(ftps, "lf", &(LAYER_D[i])); fprintf(device, "%8.2lf\t", LAYER_D[i]);
-		read(ftps, "lf", &(LAYER_L[i])); fprintf(device, "%8.2lf\t", LAYER_L[i]);
-		read(ftps, "lf", &(LAYER_A[i])); fprintf(device, "%8.2lf\t", LAYER_A[i]);
-		read(ftps, "lf", &(LAYER_B[i])); fprintf(device, "%8.2lf\t", LAYER_B[i]);
-		read(ftps, "lf", &(LAYER_TU[i])); fprintf(device, "%8.2lf\t", LAYER_TU[i]);
-		read(ftps, "lf", &(LAYER_EPS[i])); fprintf(device, "%8.2lf\t", LAYER_EPS[i]);
-		read(ftps, "lf", &(LAYER_AT[i])); fprintf(device, "%8.2lf\n", LAYER_AT[i]);
+		ftps.read(&(LAYER_DX[i]), true); fprintf(device, "%5.3E\t", LAYER_DX[i]);
+		ftps.read(&(LAYER_CP[i])); fprintf(device, "%8.2lf\t", LAYER_CP[i]);
+		ftps.read(&(LAYER_D[i])); fprintf(device, "%8.2lf\t", LAYER_D[i]);
+		ftps.read(&(LAYER_L[i])); fprintf(device, "%8.2lf\t", LAYER_L[i]);
+		ftps.read(&(LAYER_A[i])); fprintf(device, "%8.2lf\t", LAYER_A[i]);
+		ftps.read(&(LAYER_B[i])); fprintf(device, "%8.2lf\t", LAYER_B[i]);
+		ftps.read(&(LAYER_TU[i])); fprintf(device, "%8.2lf\t", LAYER_TU[i]);
+		ftps.read(&(LAYER_EPS[i])); fprintf(device, "%8.2lf\t", LAYER_EPS[i]);
+		ftps.read(&(LAYER_AT[i])); fprintf(device, "%8.2lf\n", LAYER_AT[i]);
 		if (isComplexTFH[i] == 1)
 			m[i] = new CUserMaterial("USERMAT", stdout, LAYER_L[i], LAYER_D[i], LAYER_CP[i], LAYER_EPS[i], LAYER_TU[i], LAYER_A[i], LAYER_B[i], AblationType[i]);
 		else
 			m[i] = new CUserMaterial("CONSTMAT", stdout, LAYER_L[i], LAYER_D[i], LAYER_CP[i], LAYER_EPS[i], LAYER_TU[i], LAYER_A[i], LAYER_B[i], AblationType[i]);
-		fflush(NULL);
 	}
-	int LAYER_CELLS[LAYERS_MAX_NUM];
+	vector<int> LAYER_CELLS(LAYERS);
 	/* ---     . --- */
 	r = true;
 	for (int i=0; i<LAYERS; i++) {
-		read(ftps, "d", &(LAYER_CELLS[i]), r); fprintf(device, "%d\t", LAYER_CELLS[i]);
+		ftps.read(&(LAYER_CELLS[i]), r); fprintf(device, "%d\t", LAYER_CELLS[i]);
 		r = false;
 	}
 	fprintf(device, "\n");
-	fflush(NULL);
 	r = true;
 	/* ---   ,      . --- */
+	prn->PRINT_CELLS = new int[max(prn->PRINT_CELLS_NUM, 1)];
 	for (int i=0; i<prn->PRINT_CELLS_NUM; i++) {
-		read(ftps, "d", &(prn->PRINT_CELLS[i]), r); fprintf(device, "PrintCell%d=%d\n", i, prn->PRINT_CELLS[i]);
+		ftps.read(&(prn->PRINT_CELLS[i]), r); fprintf(device, "PrintCell%d=%d\n", i, prn->PRINT_CELLS[i]);
 		r = false;
 	}
 	fprintf(device, "\n");
@@ -251,104 +342,97 @@ thm_t* thm_parse(const char* filename, FILE* device, CBluntedCone** BCone, gasdy
 	fprintf(device, "--- SPECIAL PARAMETERS ---\n");
 	fprintf(device, "%11.11s\t%11.11s\t%11.11s\t%11.11s\t%11.11s\t%11.11s\t%11.11s\n", "AXIS_LEN", "R0", "TH0", "TIMESTEP", "TIME_PRINT", "TR_HEIGHT", "PHI0");
 	/*    . */
-	read(ftps, "lf", &(gd->X), true); fprintf(device, "%11.5lf\t", gd->X);
+	ftps.read(&(gd->X), true); fprintf(device, "%11.5lf\t", gd->X);
 	double R0; /*  , . */
-	read(ftps, "lf", &(R0)); fprintf(device, "%11.5lf\t", R0);
+	ftps.read(&(R0)); fprintf(device, "%11.5lf\t", R0);
 	double TH; /*  , . */
-	read(ftps, "lf", &(TH)); fprintf(device, "%11.5lf\t", TH);
+	ftps.read(&(TH)); fprintf(device, "%11.5lf\t", TH);
 	/*   , . */
-	read(ftps, "lf", &(thm->INIT_TIMESTEP)); fprintf(device, "%11.5lf\t", thm->INIT_TIMESTEP);
+	ftps.read(&(thm->INIT_TIMESTEP)); fprintf(device, "%11.5lf\t", thm->INIT_TIMESTEP);
 	/*  , . */
-	read(ftps, "lf", &(prn->print_interval)); fprintf(device, "%11.5lf\t", prn->print_interval);
+	ftps.read(&(prn->print_interval)); fprintf(device, "%11.5lf\t", prn->print_interval);
 	/*  , . */
-	read(ftps, "lf", &(gd->HT)); fprintf(device, "%11.5lf\t", gd->HT);
+	ftps.read(&(gd->HT)); fprintf(device, "%11.5lf\t", gd->HT);
 	/*       . */
-	read(ftps, "lf", &(gd->PHI0)); fprintf(device, "%11.5lf\n", gd->PHI0);
+	ftps.read(&(gd->PHI0)); fprintf(device, "%11.5lf\n", gd->PHI0);
 	*BCone = new CBluntedCone(R0, TH);
 	/* ---      . --- */
 	fprintf(device, "--- MACH, ALPHA AND PHI ---\n");
 	double MACHS[6];
 	r = true;
 	for (int i=0; i<6; i++) {
-		read(ftps, "lf", &(MACHS[i]), r); fprintf(device, "%11.5lf\t", MACHS[i]);
+		ftps.read(&(MACHS[i]), r); fprintf(device, "%11.5lf\t", MACHS[i]);
 		r = false;
 	}
 	fprintf(device, "\n");
 	r = true;
 	double ALPHAS[7];
 	for (int i=0; i<7; i++) {
-		read(ftps, "lf", &(ALPHAS[i]), r); fprintf(device, "%11.5lf\t", ALPHAS[i]);
+		ftps.read(&(ALPHAS[i]), r); fprintf(device, "%11.5lf\t", ALPHAS[i]);
 		r = false;
 	}
 	fprintf(device, "\n");
 	r = true;
 	double PHIS[3];
 	for (int i=0; i<3; i++) {
-		read(ftps, "lf", &(PHIS[i]), r); fprintf(device, "%11.5lf\t", PHIS[i]);
+		ftps.read(&(PHIS[i]), r); fprintf(device, "%11.5lf\t", PHIS[i]);
 		r = false;
 	}
 	fprintf(device, "\n");
 	/* ---   . --- */
+	const int knots[3] = {6, 7, 3};
+	const double* axes[3] = {MACHS, ALPHAS, PHIS};
+	gd->PP0.create(knots, axes);
+	gd->XET.create(knots, axes);
+	gd->XEL.create(knots, axes);
 	/* --   P/P0 */
 	fprintf(device, "--- PP0 ---\n");
 //	double PP0[3][7][6];
 	for (int k=0; k<3; k++) {
-		ITable * tbl = new ITable();
 		for (int i=0; i<7; i++) {
-			IFunc* func = new IFunc();
 			double pp0;
 			r = true;
 			for (int j=0; j<6; j++) {
-				read(ftps, "lf", &(pp0), r); fprintf(device, "%11.5lf\t", pp0);
-				fflush(NULL);
-				func->add(MACHS[j], pp0);
+				ftps.read(&(pp0), r); fprintf(device, "%11.5lf\t", pp0);
+				const int node[3] = {j, i, k};
+				gd->PP0.set(node, pp0);
 				r = false;
 			}
-			tbl->add(func, ALPHAS[i]);
 			fprintf(device, "\n");
 		}
-		gd->PP0.add(tbl, PHIS[k]);
 	}
 	/* --      Xeft^0.2 */
 	fprintf(device, "--- XEFT ---\n");
 	for (int k=0; k<3; k++) {
-		ITable * tbl = new ITable();
 		
 		for (int i=0; i<7; i++) {
-			IFunc* func = new IFunc();
 			double xet;
 			r = true;
 			for (int j=0; j<6; j++) {
-				read(ftps, "lf", &(xet), r); fprintf(device, "%11.5lf\t", xet);
+				ftps.read(&(xet), r); fprintf(device, "%11.5lf\t", xet);
 				
 				r = false;
-				func->add(MACHS[j], xet);
+				const int node[3] = {j, i, k};
+				gd->XET.set(node, xet);
 			}
-			tbl->add(func, ALPHAS[i]);
 			fprintf(device, "\n");
 		}
-		gd->XET.add(tbl, PHIS[k]);
 	}
-	fflush(NULL);
 	/* --      Xefl^0.5 */
 	fprintf(device, "--- XEFL ---\n");
 	for (int k=0; k<3; k++) {
-		ITable * tbl = new ITable();
 		for (int i=0; i<7; i++) {
-			IFunc* func = new IFunc();
 			double xel;
 			r = true;
 			for (int j=0; j<6; j++) {
-				read(ftps, "lf", &(xel), r); fprintf(device, "%11.5lf\t", xel);
+				ftps.read(&(xel), r); fprintf(device, "%11.5lf\t", xel);
 				r = false;
-				func->add(MACHS[j], xel);
+				const int node[3] = {j, i, k};
+				gd->XEL.set(node, xel);
 			}
-			tbl->add(func, ALPHAS[i]);
 			fprintf(device, "\n");
 		}
-		gd->XEL.add(tbl, PHIS[k]);
 	}
-	fflush(NULL);
 	/* ---   . --- */
 	func_points_t tfh;
 	tfh.count = 10;
@@ -358,31 +442,31 @@ thm_t* thm_parse(const char* filename, FILE* device, CBluntedCone** BCone, gasdy
 		if (isComplexTFH[i] == 1) {
 			r = true;
 			for (int j=0; j<10; j++) {
-				read(ftps, "lf", &(tfh.x[j]), r); fprintf(device, "%11.5lf\t", tfh.x[j]);
+				ftps.read(&(tfh.x[j]), r); fprintf(device, "%11.5lf\t", tfh.x[j]);
 				r = false;
 			}
 			fprintf(device, "\n");
-			fflush(NULL);
 			r = true;
 			for (int j=0; j<10; j++) {
-				read(ftps, "lf", &(tfh.y[j]), r); fprintf(device, "%11.5lf\t", tfh.y[j]);
+				ftps.read(&(tfh.y[j]), r); fprintf(device, "%11.5lf\t", tfh.y[j]);
 				r = false;
 			}
 			m[i]->update("CP", &tfh);
 			fprintf(device, "\n");
-			fflush(NULL);
 			r = true;
 			for (int j=0; j<10; j++) {
-				read(ftps, "lf", &(tfh.y[j]), r); fprintf(device, "%11.5lf\t", tfh.y[j]);
+				ftps.read(&(tfh.y[j]), r); fprintf(device, "%11.5lf\t", tfh.y[j]);
 				r = false;
 			}
 			m[i]->update("L", &tfh);
 			fprintf(device, "\n");
-			fflush(NULL);
 		}
 	}
-	fclose(ftps);
 	fprintf(device, "\n%s\t%s\t%s\n", "LAYER_DX[i]", "m[i]", "T0");
+	int CELLS = 0; /* Total number of cells at the model. */
+	for (int i=0; i<LAYERS; i++)
+		CELLS += LAYER_CELLS[i];
+	thm->reserve(CELLS);
 	for (int i=0; i<LAYERS; i++) { /*    . */
 		thm->add(LAYER_CELLS[i], LAYER_DX[i], m[i], T0);
 		fprintf(device, "%lf\t%s\t%lf\n", LAYER_DX[i], m[i]->name(), T0);
@@ -3,16 +3,25 @@
 #include <assert.h>
 #include <boundary.h>
 
+/* Names of the parameters in order of BC_PARAMS */
+static const char* BC_NAMES[BC_PARAMS] = {"acp", "Ie", "Iw", "I0", "eps", "Tw", "P"};
+
 CBoundary::CBoundary(int Type, FILE* flog)
 {
 
 	this->Type = Type;
 	this->flog = flog;
+	for (int i=0; i<BC_PARAMS; i++)
+		COEF[i].count = 0;
+	COEFS = 0;
 }
 CBoundary::CBoundary(CBoundary *boundary)
 {
 	this->Type = boundary->type();
 	this->flog = boundary->flog;
+	for (int i=0; i<BC_PARAMS; i++)
+		COEF[i].count = 0;
+	COEFS = 0;
 	BC_t BCtemp = boundary->GetBC(0.);
 	BC.eps = BCtemp.eps;
 	BC.Tw = BCtemp.Tw;
@@ -20,10 +29,46 @@ CBoundary::CBoundary(CBoundary *boundary)
 	BC.Iw = BCtemp.Iw;
 	BC.acp = BCtemp.acp;
 }
+CBoundary::~CBoundary()
+{
+	for (int i=0; i<BC_PARAMS; i++)
+		if (COEF[i].count > 0) {
+			free(COEF[i].x);
+			free(COEF[i].y);
+		}
+}
 int CBoundary::type()
 {
 	return this->Type;
 }
+int CBoundary::setCoefs(const char* pname, const func_points_t* table, unsigned mask)
+{
+	int i;
+	for (i=0; (i<BC_PARAMS) && ((pname == 0) || (strcmp(pname, BC_NAMES[i]) != 0)); i++);
+	if ((i == BC_PARAMS) || !(mask & (1u << i)))
+		return -2;
+	if ((table == 0) || (table->count <= 0) || (table->x == 0) || (table->y == 0))
+		return NULL_VALUE;
+	if (COEF[i].count > 0) {
+		free(COEF[i].x);
+		free(COEF[i].y);
+		COEFS--;
+	}
+	func_points_cpy(table, &(COEF[i]));
+	COEFS++;
+	return SUCCESS;
+}
+BC_t CBoundary::scaled(double Time)
+{
+	if (COEFS == 0)
+		return BC;
+	BC_t bc = BC;
+	double* value[BC_PARAMS] = {&bc.acp, &bc.Ie, &bc.Iw, &bc.I0, &bc.eps, &bc.Tw, &bc.P};
+	for (int i=0; i<BC_PARAMS; i++)
+		if (COEF[i].count > 0)
+			*value[i] *= in_LinearFunc(&(COEF[i]), Time);
+	return bc;
+}
 
 CFOBoundary::CFOBoundary(double Tw, FILE* flog) : CBoundary(1, flog)
 {
@@ -37,9 +82,14 @@ CFOBoundary::CFOBoundary(double Tw, FILE* flog) : CBoundary(1, flog)
 	BC.Tw = Tw;
 	this->flog = flog;
 }
+void CFOBoundary::set(double Tw)
+{
+	assert(Tw >= 0);
+	BC.Tw = Tw;
+}
 BC_t CFOBoundary::GetBC(double Time)
 {
-	return BC;
+	return scaled(Time);
 }
 
 void CFOBoundary::print()
@@ -49,8 +99,7 @@ void CFOBoundary::print()
 }
 int CFOBoundary::SetTimeChangeCoefs(const char* pname, const func_points_t* table)
 {
-	assert(0);
-	return NULL_VALUE;
+	return setCoefs(pname, table, 1u << 5);
 }
 
 CSOBoundary::CSOBoundary(double acp, double I0, double Ie, double Iw,  double Ps, double eps, FILE* flog) : CBoundary(2, flog)
@@ -67,9 +116,20 @@ CSOBoundary::CSOBoundary(double acp, double I0, double Ie, double Iw,  double Ps
 	BC.Tw = -1.;
 	this->flog = flog;
 }
+void CSOBoundary::set(double acp, double I0, double Ie, double Iw, double Ps, double eps)
+{
+	assert(Ie >= 0.);
+	assert(eps >= 0.);
+	BC.eps = eps;
+	BC.I0 = I0;
+	BC.Ie = Ie;
+	BC.Iw = Iw;
+	BC.P = Ps;
+	BC.acp = acp;
+}
 BC_t CSOBoundary::GetBC(double Time) {
 
-	return BC;
+	return scaled(Time);
 }
 
 void CSOBoundary::print() {
@@ -79,6 +139,6 @@ void CSOBoundary::print() {
 }
 int CSOBoundary::SetTimeChangeCoefs(const char* pname, const func_points_t* table)
 {
-	assert(0);
-	return NULL_VALUE;
+	/* All parameters but Tw */
+	return setCoefs(pname, table, ((1u << BC_PARAMS)-1) & ~(1u << 5));
 }
@@ -0,0 +1,36 @@
+#include <checkpoint.h>
+#include <avdsolver.h>
+#include <cstring>
+
+int checkpoint_save(const char* filename, const ckpt_t& ckpt, const AVDSolver& solver)
+{
+	char tmp[FILENAME_MAX_LEN+4];
+	sprintf(tmp, "%.*s.tmp", FILENAME_MAX_LEN-1, filename);
+	FILE* f = fopen(tmp, "wb");
+	if (f == 0)
+		return NULL_VALUE;
+	ckpt_write(f, CKPT_MAGIC, strlen(CKPT_MAGIC));
+	ckpt_write(f, &ckpt);
+	solver.save(f);
+	bool failed = (ferror(f) != 0);
+	failed = (fclose(f) != 0) || failed;
+	if (failed || (rename(tmp, filename) != 0)) {
+		remove(tmp);
+		return NULL_VALUE;
+	}
+	return SUCCESS;
+}
+
+int checkpoint_load(const char* filename, ckpt_t* ckpt, AVDSolver* solver)
+{
+	char magic[sizeof(CKPT_MAGIC)];
+	FILE* f = fopen(filename, "rb");
+	if (f == 0)
+		return NULL_VALUE;
+	int res = SUCCESS;
+	if (!ckpt_read(f, magic, strlen(CKPT_MAGIC)) || (memcmp(magic, CKPT_MAGIC, strlen(CKPT_MAGIC)) != 0) ||
+		!ckpt_read(f, ckpt) || (solver->load(f) != SUCCESS))
+		res = NULL_VALUE;
+	fclose(f);
+	return res;
+}
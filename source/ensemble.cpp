@@ -0,0 +1,205 @@
+#include <ensemble.h>
+#include <boundary.h>
+#include <threadpool.h>
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include <string>
+
+/** Разобранный файл ИД ТЗП. */
+typedef struct {
+	thm_t* thm;
+	CBluntedCone* BCone;
+	gasdynamics_t gd;
+	print_t prn;
+} tps_t;
+
+/** Вариант ансамбля. */
+typedef struct {
+	/** Траектория (общая для всех вариантов с этим файлом). */
+	trm_t* trm;
+	/** ТЗП (общая для всех вариантов с этим файлом). */
+	const tps_t* tps;
+	/** Параметры точки поверхности варианта. */
+	gasdynamics_t gd;
+	/** Оценка времени счёта: длительность траектории на количество ячеек. */
+	double COST;
+	/** Файл результатов варианта. */
+	char RES[FILENAME_MAX_LEN];
+	/** Результат расчёта варианта: SUCCESS или код ошибки. */
+	int STATUS;
+} case_t;
+
+/**
+ * @brief Расчёт вариантов ансамбля "траектория x ТЗП x точка поверхности".
+ * @details Разобранные файлы ИД только читаются, каждый вариант рассчитывается
+ * своим решателем на копии тепловой модели и выводит результаты в свой файл.
+ * Варианты раздаются потокам по одному в порядке убывания оценки времени
+ * счёта, поэтому долгие варианты не остаются на конец расчёта. Ошибка
+ * варианта не прерывает расчёт остальных.
+ */
+class CEnsembleTask : public CTask {
+	/** Настройки решателей. */
+	const options_t& opt;
+	/** Варианты ансамбля. */
+	vector<case_t>& cases;
+	/** Номера вариантов в порядке выдачи потокам. */
+	vector<int> order;
+	/** Количество завершённых вариантов. */
+	atomic<int> done;
+	/** Таблицы результатов выводятся в двоичные файлы. */
+	bool BINARY;
+	/**
+	 * @brief Рассчитать вариант.
+	 * @return SUCCESS или NULL_VALUE, если файлы результатов не созданы или настройки
+	 * не подходят к модели, или код ошибки шага счёта, на котором расчёт остановлен.
+	 */
+	int solve(case_t& c)
+	{
+		const print_t& prn = c.tps->prn;
+		thm_t thm(*c.tps->thm);
+		AVDSolver solver(&thm, c.trm, &c.gd, c.tps->BCone);
+		if (configure(&solver, &thm, opt, prn) != SUCCESS)
+			return NULL_VALUE;
+		thm.CURRENT_TIME = c.trm->BEGIN_TIME;
+		FILE* f = fopen(c.RES, "wt");
+		if (f == 0) {
+			printf("[EE]: Can't create results file %s\n", c.RES);
+			return NULL_VALUE;
+		}
+		vector<res_column_t> columns = result_columns(&thm, prn, 0);
+		vector<double> row(columns.size());
+		CResultWriter* writer = 0;
+		if (BINARY) {
+			/* Таблица в файле <траектория>-<ТЗП>-<n>.bres. */
+			char filename[FILENAME_MAX_LEN+1];
+			sprintf(filename, "%.*sbres", (int)strlen(c.RES)-3, c.RES);
+			writer = new CResultWriter(filename, columns, vector<int>(prn.PRINT_CELLS, prn.PRINT_CELLS+prn.PRINT_CELLS_NUM));
+			if (!writer->isOpen()) {
+				delete writer;
+				fclose(f);
+				return NULL_VALUE;
+			}
+		} else
+			print_header(f, columns);
+		int STATUS = SUCCESS;
+		int PICARD_ITERS = 0;
+		int PICARD_MAX = 0;
+		for (double time = c.trm->BEGIN_TIME+prn.print_interval; (thm.CURRENT_TIME < c.trm->END_TIME); time += min(prn.print_interval, c.trm->END_TIME-time)) {
+			avdsolver_t info = solver.Solve(time);
+			if (info.STATUS != SUCCESS) {
+				/* Выведенные строки сохраняются, итоги не выводятся. */
+				fprintf(f, "\nFAILED AT %.2lf S\n", thm.CURRENT_TIME);
+				STATUS = info.STATUS;
+				break;
+			}
+			PICARD_ITERS += info.PICARD_ITERS;
+			PICARD_MAX = max(PICARD_MAX, info.PICARD_MAX);
+			result_row(&(row[0]), info, &thm, prn, 0);
+			if (writer != 0)
+				writer->write(&(row[0]));
+			else
+				print_row(f, columns, &(row[0]));
+		}
+		if ((writer != 0) && (writer->close() != SUCCESS)) {
+			printf("[EE]: Can't write results of %s\n", c.RES);
+			STATUS = NULL_VALUE;
+		}
+		delete writer;
+		if ((STATUS == SUCCESS) && (opt.PICARD_TOL > 0.))
+			fprintf(f, "\nPICARD ITERATIONS: %d (MAX PER STAGE: %d)\n", PICARD_ITERS, PICARD_MAX);
+		if ((STATUS == SUCCESS) && (opt.MEMO_DT > 0.))
+			fprintf(f, "\nMEMO HITS: %ld OF %ld STEPS (%.1lf%%)\n", solver.memo().HITS, solver.memo().CALLS,
+				(solver.memo().CALLS > 0) ? 100.*solver.memo().HITS/solver.memo().CALLS : 0.);
+		fclose(f);
+		return STATUS;
+	}
+public:
+	CEnsembleTask(const options_t& opt, vector<case_t>& cases, bool BINARY) : opt(opt), cases(cases), done(0), BINARY(BINARY)
+	{
+		for (size_t k=0; k<cases.size(); k++)
+			order.push_back((int)k);
+		stable_sort(order.begin(), order.end(), [&cases](int a, int b) { return cases[a].COST > cases[b].COST; });
+	}
+	virtual void run(int index, int thread)
+	{
+		case_t& c = cases[order[index]];
+		c.STATUS = solve(c);
+		printf("CASE %d OF %d: %s%s\n", ++done, (int)cases.size(), c.RES, (c.STATUS != SUCCESS) ? " FAILED" : "");
+	}
+};
+
+int ensemble(const char* manifest, const options_t& opt, bool BINARY)
+{
+	char line[STRING_MAX_LEN];
+	char filename[FILENAME_MAX_LEN];
+	map<string, trm_t*> trajectories;
+	map<string, tps_t> models;
+	vector<case_t> cases;
+	FILE* f = fopen(manifest, "rt");
+	if (f == 0) {
+		printf("[EE]: Can't open ensemble manifest %s\n", manifest);
+		exit(-1);
+	}
+	if (strlen(manifest)+5 > FILENAME_MAX_LEN) {
+		printf("[EE]: Ensemble manifest name %s is too long\n", manifest);
+		exit(-1);
+	}
+	sprintf(filename, "%s.log", manifest);
+	FILE* flog = fopen(filename, "wt");
+	assert(flog != 0);
+	fprintf(flog, "\n--- SOURCES ---\n");
+	while (fgets(line, STRING_MAX_LEN, f) != 0) {
+		char TR[FILENAME_MAX_LEN], TPS[FILENAME_MAX_LEN];
+		double X, PHI;
+		char* comment = strchr(line, '#');
+		if (comment != 0)
+			*comment = 0;
+		/* Длина имён ограничена форматом, чтобы имя файла результатов поместилось в буфер. */
+		int n = sscanf(line, "%100s %100s %lf %lf", TR, TPS, &X, &PHI);
+		if (n <= 0)
+			continue;
+		if (n < 2) {
+			printf("[EE]: Incorrect ensemble manifest line: %s\n", line);
+			exit(-1);
+		}
+		/* Файлы ИД разбираются при первом упоминании. */
+		if (trajectories.count(TR) == 0)
+			trajectories[TR] = trm_parse(TR, flog);
+		if (models.count(TPS) == 0) {
+			tps_t tps;
+			tps.thm = thm_parse(TPS, flog, &tps.BCone, &tps.gd, &tps.prn);
+			tps.thm->setRBC(new CSOBoundary(0., 0., 0., 0., 0.));
+			models[TPS] = tps;
+		}
+		case_t c;
+		c.trm = trajectories[TR];
+		c.tps = &models[TPS];
+		c.gd = c.tps->gd;
+		if (n > 2)
+			c.gd.X = X;
+		if (n > 3)
+			c.gd.PHI0 = PHI;
+		c.COST = (c.trm->END_TIME-c.trm->BEGIN_TIME)*(c.tps->thm->lcnum-c.tps->thm->fcnum+1);
+		sprintf(c.RES, "%s-%s-%d.res", TR, TPS, (int)cases.size()+1);
+		c.STATUS = SUCCESS;
+		cases.push_back(c);
+	}
+	fclose(f);
+	fclose(flog);
+	if (cases.empty()) {
+		printf("[EE]: Ensemble manifest %s is empty\n", manifest);
+		exit(-1);
+	}
+	CThreadPool pool;
+	CEnsembleTask task(opt, cases, BINARY);
+	printf("ENSEMBLE: %d CASES, %d THREADS\n", (int)cases.size(), pool.size());
+	pool.run(&task, (int)cases.size());
+	int failed = 0;
+	for (size_t k=0; k<cases.size(); k++)
+		if (cases[k].STATUS != SUCCESS)
+			failed++;
+	if (failed > 0)
+		printf("ENSEMBLE: %d OF %d CASES FAILED\n", failed, (int)cases.size());
+	return failed;
+}
@@ -0,0 +1,107 @@
+#include <heatflux.h>
+#include <cstring>
+
+void CAvdHeatFlux::apply(double time, avd_t* avd, int* cursor) const
+{
+}
+
+CTableHeatFlux::CTableHeatFlux(const char* filename)
+{
+	vector<double> X, Y;
+	double x, y;
+	FILE* f = fopen(filename, "rt");
+	if (f == 0) {
+		printf("[EE]: Can't open heat flux table %s\n", filename);
+		exit(-1);
+	}
+	while (fscanf(f, "%lf %lf", &x, &y) == 2) {
+		if (!X.empty() && (x < X.back())) {
+			printf("[EE]: Time %lf of heat flux table %s is not ascending\n", x, filename);
+			exit(-1);
+		}
+		X.push_back(x);
+		Y.push_back(y);
+	}
+	fclose(f);
+	if (X.empty()) {
+		printf("[EE]: Heat flux table %s is empty\n", filename);
+		exit(-1);
+	}
+	const int count = (int)X.size();
+	const double* axis = &(X[0]);
+	Q.create(&count, &axis);
+	for (int k=0; k<count; k++)
+		Q.set(&k, Y[k]);
+}
+
+void CTableHeatFlux::apply(double time, avd_t* avd, int* cursor) const
+{
+	avd->QCONV = Q.val(time, cursor);
+	avd->ALC = avd->QCONV/(avd->IE-avd->IW);
+	avd->ALC1 = avd->ALC;
+}
+
+CReplayHeatFlux::CReplayHeatFlux(const char* filename)
+{
+	char line[STRING_MAX_LEN];
+	vector<double> T, Q, P, A, I;
+	bool results = false;
+	FILE* f = fopen(filename, "rt");
+	if (f == 0) {
+		printf("[EE]: Can't open results %s for replay\n", filename);
+		exit(-1);
+	}
+	/* Rows of RESULTS: TIME QCONV DY T1 T2 P ALC IE ... */
+	while (fgets(line, STRING_MAX_LEN, f) != 0) {
+		double t, q, dy, t1, t2, p, alc, ie;
+		if (strstr(line, "--- RESULTS ---") != 0)
+			results = true;
+		else if (results && (sscanf(line, "%lf %lf %lf %lf %lf %lf %lf %lf", &t, &q, &dy, &t1, &t2, &p, &alc, &ie) == 8)) {
+			if (!T.empty() && (t <= T.back()))
+				continue;
+			T.push_back(t);
+			Q.push_back(q*4186.8);
+			P.push_back(p);
+			A.push_back(alc);
+			I.push_back(ie*4186.8);
+		}
+	}
+	fclose(f);
+	if (T.empty()) {
+		printf("[EE]: No results to replay in %s\n", filename);
+		exit(-1);
+	}
+	const int count = (int)T.size();
+	const double* axis = &(T[0]);
+	CInterp<1>* column[] = {&QCONV, &P1, &ALC, &IE};
+	const vector<double>* values[] = {&Q, &P, &A, &I};
+	for (int c=0; c<4; c++) {
+		column[c]->create(&count, &axis);
+		for (int k=0; k<count; k++)
+			column[c]->set(&k, (*values[c])[k]);
+	}
+}
+
+void CReplayHeatFlux::apply(double time, avd_t* avd, int* cursor) const
+{
+	/* The columns share the time axis, so one cursor serves all of them. */
+	avd->QCONV = QCONV.val(time, cursor);
+	avd->P1 = P1.val(time, cursor);
+	avd->ALC = ALC.val(time, cursor);
+	avd->ALC1 = avd->ALC;
+	avd->IE = IE.val(time, cursor);
+}
+
+CScaledHeatFlux::CScaledHeatFlux(const CHeatFlux* flux, double k)
+{
+	FLUX = flux;
+	K = k;
+}
+
+void CScaledHeatFlux::apply(double time, avd_t* avd, int* cursor) const
+{
+	FLUX->apply(time, avd, cursor);
+	avd->QCONV *= K;
+	avd->ALC *= K;
+	avd->ALC1 *= K;
+}
@@ -1,88 +1,545 @@
 #include <common.h>
+#include <cstring>
 #include <avdtparser.h>
 #include <bluntedcone.h>
 //#include <avdheatflux.h>
-//#include <atmosphere.h>
+#include <atmosphere.h>
 #include <thsolver.h>
 //#include <unos.h>
 //#include <avdbc.h>
 #include <boundary.h>
 #include <avdsolver.h>
+#include <adisolver.h>
+#include <surfacemap.h>
+#include <montecarlo.h>
+#include <checkpoint.h>
+#include <resfile.h>
+#include <avdrun.h>
+#include <ensemble.h>
+#include <uncertainty.h>
+#include <sizing.h>
+#include <csignal>
+#include <chrono>
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include <string>
+
+/**
+ * @brief       .
+ * @details           .
+ */
+class CAVDStationTask : public CTask {
+	/**  . */
+	CADISolver* adi;
+public:
+	/**  . */
+	vector<AVDSolver*> solver;
+	/**    . */
+	vector<avdsolver_t> info;
+	CAVDStationTask(CADISolver* adi)
+	{
+		this->adi = adi;
+	}
+	void add(AVDSolver* solver)
+	{
+		this->solver.push_back(solver);
+		info.resize(this->solver.size());
+	}
+	virtual void run(int index, int thread)
+	{
+		if (adi->station(index)->CURRENT_TIME < adi->target()) {
+			info[index] = solver[index]->Solve(adi->target());
+			/*     ,      . */
+			if (info[index].STATUS != SUCCESS)
+				exit(-1);
+		}
+	}
+};
+
+/**  ,      (0 -  ). */
+static volatile sig_atomic_t CKPT_SIGNAL = 0;
+
+/**   SIGUSR1 (  )  SIGTERM (   ). */
+static void checkpoint_signal(int sig)
+{
+	CKPT_SIGNAL = sig;
+}
+
+/**         . */
+static void usage()
+{
+	printf("INCORRECT PROGRAM USAGE!\n");
+	printf("avd [--scheme euler|trbdf2] [--tol K] [--dtmax s] [--picard K] [--remesh K] [--moving] [--adi x1,x2,... [--adistep s]] [--map x1,x2,...[:phi1,phi2,...]] [--atmstep m] [--memo dt,dTw] [--flux avd|table:FILE|replay:FILE] [--bccoef NAME:FILE] [--mc FILE [--samples n] [--seed n]] [--size l1,l2,...:CELL:TMAX] [--checkpoint FILE[:s]] [--restart FILE] [--binary] [TRAJECTORY TPS | --ensemble MANIFEST | --totext FILE.bres]\n");
+	printf("--picard: fixed-point iterations of the implicit stages on the temperature-dependent properties and boundary radiation to the tolerance K\n");
+	printf("--adi: 2-D conduction along the generatrix by Strang splitting (half lateral step, through-thickness step, half lateral step) with the splitting step --adistep\n");
+	exit(-1);
+}
+
+/**
+ * @brief   " "   .
+ * @param filename -  .
+ * @param table -  (  ).
+ * @return SUCCESS  NULL_VALUE,       .
+ */
+static int load_points(const char* filename, func_points_t* table)
+{
+	vector<double> x, y;
+	double a, b;
+	FILE* f = fopen(filename, "rt");
+	if (f == 0)
+		return NULL_VALUE;
+	while (fscanf(f, "%lf %lf", &a, &b) == 2) {
+		x.push_back(a);
+		y.push_back(b);
+	}
+	fclose(f);
+	if (x.empty())
+		return NULL_VALUE;
+	func_points_t src;
+	src.x = &(x[0]);
+	src.y = &(y[0]);
+	src.count = (int)x.size();
+	func_points_cpy(&src, table);
+	return SUCCESS;
+}
 
 int main(int argc, char *argv[])
 {
 	char iTRFilename[FILENAME_MAX_LEN];
 	char iTPSFilename[FILENAME_MAX_LEN];
 	char rFilename[FILENAME_MAX_LEN];
+	options_t opt;
+	opt.SCHEME = SCHEME_EULER;
+	opt.TOL = 1.;
+	opt.TIMESTEP_MAX = 0.;
+	opt.PICARD_TOL = 0.;
+	opt.REMESH_DT = 0.;
+	opt.MOVING = false;
+	opt.MEMO_DT = 0.;
+	opt.MEMO_DTW = 0.;
+	const char* FLUX = "table:q.txt"; /*   . */
+	vector<double> ADI_X; /*    , . */
+	double ADI_STEP = 1.; /*    , . */
+	vector<double> MAP_X; /*    , . */
+	vector<double> MAP_PHI; /*    , . */
+	double ATM_STEP = 0.; /*    ,  (0 -   ). */
+	int FILES = 0; /*       . */
+	const char* ENSEMBLE = 0; /*   . */
+	const char* MC = 0; /*     -. */
+	int MC_SAMPLES = 1000; /*    -. */
+	uint64_t MC_SEED = 1; /*     -. */
+	vector<int> SIZE_LAYERS; /*  ,   . */
+	int SIZE_CELL = 0; /* ,     . */
+	const char* CKPT = 0; /*   . */
+	double CKPT_PERIOD = 600.; /*    ,   . */
+	const char* RESTART = 0; /*  ,    . */
+	bool BINARY = false; /*      . */
+	double SIZE_TMAX = 0.; /*   , . */
 
-	switch (argc) {
-	case 0:
-		assert(0);
-	case 1: /*      . */
+	assert(argc > 0);
+	for (int i=1; i<argc; i++) {
+		if ((strcmp(argv[i], "--scheme") == 0) && (i+1 < argc)) {
+			i++;
+			if (strcmp(argv[i], "euler") == 0)
+				opt.SCHEME = SCHEME_EULER;
+			else if (strcmp(argv[i], "trbdf2") == 0)
+				opt.SCHEME = SCHEME_TRBDF2;
+			else
+				usage();
+		} else if ((strcmp(argv[i], "--tol") == 0) && (i+1 < argc)) {
+			opt.TOL = atof(argv[++i]);
+			if (opt.TOL <= 0.)
+				usage();
+		} else if ((strcmp(argv[i], "--dtmax") == 0) && (i+1 < argc)) {
+			opt.TIMESTEP_MAX = atof(argv[++i]);
+			if (opt.TIMESTEP_MAX < STD_TIMESTEP_MIN)
+				usage();
+		} else if ((strcmp(argv[i], "--picard") == 0) && (i+1 < argc)) {
+			opt.PICARD_TOL = atof(argv[++i]);
+			if (opt.PICARD_TOL <= 0.)
+				usage();
+		} else if ((strcmp(argv[i], "--remesh") == 0) && (i+1 < argc)) {
+			opt.REMESH_DT = atof(argv[++i]);
+			if (opt.REMESH_DT <= 0.)
+				usage();
+		} else if (strcmp(argv[i], "--moving") == 0) {
+			opt.MOVING = true;
+		} else if ((strcmp(argv[i], "--adi") == 0) && (i+1 < argc)) {
+			/*     . */
+			for (char* p = strtok(argv[++i], ","); p != 0; p = strtok(0, ","))
+				ADI_X.push_back(atof(p));
+			if (ADI_X.size() < 2)
+				usage();
+		} else if ((strcmp(argv[i], "--adistep") == 0) && (i+1 < argc)) {
+			ADI_STEP = atof(argv[++i]);
+			if (ADI_STEP <= 0.)
+				usage();
+		} else if ((strcmp(argv[i], "--map") == 0) && (i+1 < argc)) {
+			/*  :   ( )   . */
+			char* angles = strchr(argv[++i], ':');
+			if (angles != 0)
+				*(angles++) = 0;
+			for (char* p = strtok(argv[i], ","); p != 0; p = strtok(0, ","))
+				MAP_X.push_back(atof(p));
+			for (char* p = (angles != 0) ? strtok(angles, ",") : 0; p != 0; p = strtok(0, ","))
+				MAP_PHI.push_back(atof(p));
+			if (MAP_X.empty() || ((angles != 0) && MAP_PHI.empty()))
+				usage();
+		} else if ((strcmp(argv[i], "--memo") == 0) && (i+1 < argc)) {
+			/*       . */
+			if ((sscanf(argv[++i], "%lf,%lf", &opt.MEMO_DT, &opt.MEMO_DTW) != 2) || (opt.MEMO_DT <= 0.) || (opt.MEMO_DTW <= 0.))
+				usage();
+		} else if ((strcmp(argv[i], "--bccoef") == 0) && (i+1 < argc)) {
+			/*      " ". */
+			char* filename = strchr(argv[++i], ':');
+			if (filename == 0)
+				usage();
+			*(filename++) = 0;
+			func_points_t table;
+			if (load_points(filename, &table) != SUCCESS) {
+				printf("[EE]: Can't read table %s of boundary parameter %s\n", filename, argv[i]);
+				exit(-1);
+			}
+			opt.BC_NAMES.push_back(argv[i]);
+			opt.BC_COEFS.push_back(table);
+		} else if ((strcmp(argv[i], "--flux") == 0) && (i+1 < argc)) {
+			FLUX = argv[++i];
+		} else if ((strcmp(argv[i], "--atmstep") == 0) && (i+1 < argc)) {
+			ATM_STEP = atof(argv[++i]);
+			if (ATM_STEP <= 0.)
+				usage();
+		} else if ((strcmp(argv[i], "--mc") == 0) && (i+1 < argc)) {
+			MC = argv[++i];
+		} else if ((strcmp(argv[i], "--samples") == 0) && (i+1 < argc)) {
+			MC_SAMPLES = atoi(argv[++i]);
+			if (MC_SAMPLES <= 0)
+				usage();
+		} else if ((strcmp(argv[i], "--seed") == 0) && (i+1 < argc)) {
+			MC_SEED = strtoull(argv[++i], 0, 10);
+		} else if ((strcmp(argv[i], "--size") == 0) && (i+1 < argc)) {
+			/*   ,      . */
+			char* cell = strchr(argv[++i], ':');
+			if ((cell == 0) || (sscanf(cell+1, "%d:%lf", &SIZE_CELL, &SIZE_TMAX) != 2) || (SIZE_TMAX <= 0.))
+				usage();
+			*cell = 0;
+			for (char* p = strtok(argv[i], ","); p != 0; p = strtok(0, ","))
+				SIZE_LAYERS.push_back(atoi(p));
+			if (SIZE_LAYERS.empty())
+				usage();
+		} else if ((strcmp(argv[i], "--checkpoint") == 0) && (i+1 < argc)) {
+			/*   ( )  . */
+			char* period = strchr(argv[++i], ':');
+			if (period != 0) {
+				*(period++) = 0;
+				CKPT_PERIOD = atof(period);
+				if (CKPT_PERIOD <= 0.)
+					usage();
+			}
+			CKPT = argv[i];
+		} else if ((strcmp(argv[i], "--restart") == 0) && (i+1 < argc)) {
+			RESTART = argv[++i];
+		} else if (strcmp(argv[i], "--binary") == 0) {
+			BINARY = true;
+		} else if ((strcmp(argv[i], "--totext") == 0) && (i+1 < argc)) {
+			/*         . */
+			if (res_convert(argv[++i], stdout) != SUCCESS) {
+				printf("[EE]: Can't convert results file %s\n", argv[i]);
+				exit(-1);
+			}
+			return 0;
+		} else if ((strcmp(argv[i], "--ensemble") == 0) && (i+1 < argc)) {
+			ENSEMBLE = argv[++i];
+		} else if ((argv[i][0] != '-') && (FILES < 2) && (strlen(argv[i]) < FILENAME_MAX_LEN)) {
+			strcpy((FILES == 0) ? iTRFilename : iTPSFilename, argv[i]);
+			FILES++;
+		} else
+			usage();
+	}
+	/*          . */
+	if ((ENSEMBLE != 0) && ((FILES > 0) || !ADI_X.empty() || !MAP_X.empty()))
+		usage();
+	switch ((ENSEMBLE != 0) ? 2 : FILES) {
+	case 0: /*      . */
 		printf("TRAJECTORY FILENAME:");
 		scanf("%s", iTRFilename);
 		printf("TPS FILENAME:");
 		scanf("%s", iTPSFilename);
 		break;
+	case 2:
+		break;
 	default: /*   . */
-		printf("INCORRECT PROGRAM USAGE!\n");
-		exit(-1);
+		usage();
+	}
+	/*     ,    . */
+	if (!ADI_X.empty() && (opt.REMESH_DT > 0.))
+		usage();
+	if (!ADI_X.empty() && !MAP_X.empty())
+		usage();
+	if ((MC != 0) && (!ADI_X.empty() || !MAP_X.empty() || (ENSEMBLE != 0)))
+		usage();
+	if (!SIZE_LAYERS.empty() && (!ADI_X.empty() || !MAP_X.empty() || (ENSEMBLE != 0) || (MC != 0)))
+		usage();
+	/*       . */
+	if (((CKPT != 0) || (RESTART != 0)) && (!ADI_X.empty() || !MAP_X.empty() || (ENSEMBLE != 0) || (MC != 0) || !SIZE_LAYERS.empty()))
+		usage();
+	/*         . */
+	if (strcmp(FLUX, "avd") == 0)
+		opt.FLUX = new CAvdHeatFlux();
+	else if (strncmp(FLUX, "table:", 6) == 0)
+		opt.FLUX = new CTableHeatFlux(FLUX+6);
+	else if (strncmp(FLUX, "replay:", 7) == 0)
+		opt.FLUX = new CReplayHeatFlux(FLUX+7);
+	else
+		usage();
+	if (ATM_STEP > 0.)
+		printf("ATMOSPHERE: TABLE STEP %g M, MAX RELATIVE ERROR %.1E\n", ATM_STEP, BCA_Dense(ATM_STEP));
+	if (ENSEMBLE != 0) {
+		int failed = ensemble(ENSEMBLE, opt, BINARY);
+		fflush(NULL);
+		return (failed == 0) ? 0 : -1;
 	}
 	sprintf(rFilename, "%s-%s.res", iTRFilename, iTPSFilename);
-	FILE* fout = fopen(rFilename, "wt");
-	assert(fout != 0);
+	/*          . */
+	FILE* fout = fopen(rFilename, (RESTART != 0) ? "r+" : "wt");
+	if (fout == 0) {
+		printf("[EE]: Can't open results file %s\n", rFilename);
+		exit(-1);
+	}
 	/*   . */
-	fprintf(fout, "\n--- SOURCES ---\n");
-	trm_t* trm = trm_parse(iTRFilename, fout);
+	FILE* flog = (RESTART != 0) ? tmpfile() : fout;
+	assert(flog != 0);
+	fprintf(flog, "\n--- SOURCES ---\n");
+	trm_t* trm = trm_parse(iTRFilename, flog);
 	CBluntedCone *BCone;
 	gasdynamics_t gd;
 	print_t prn;
-	thm_t* thm = thm_parse(iTPSFilename, fout, &BCone, &gd, &prn);
+	thm_t* thm = thm_parse(iTPSFilename, flog, &BCone, &gd, &prn);
+	if (flog != fout)
+		fclose(flog);
 //	CAVDBoundary *avdbc = new CAVDBoundary(thm, trm, &gd, BCone, 0);
 //	thm->setLBC(avdbc);
 	CSOBoundary *bc = new CSOBoundary(0., 0., 0., 0., 0.);
 	thm->setRBC(bc);
+	if (MC != 0) {
+		monte_carlo(MC, MC_SAMPLES, MC_SEED, fout, opt, trm, thm, &gd, BCone, prn);
+		fclose(fout);
+		fflush(NULL);
+		return 0;
+	}
+	if (!SIZE_LAYERS.empty()) {
+		sizing(SIZE_LAYERS, SIZE_CELL, SIZE_TMAX, fout, opt, trm, thm, &gd, BCone, prn);
+		fclose(fout);
+		fflush(NULL);
+		return 0;
+	}
 	AVDSolver solver(thm, trm, &gd, BCone);
-	fprintf(fout, "\n--- RESULTS ---\n");
-	fprintf(fout, "\n%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%5.5s\t%7.7s\t", "TIME", "QCONV", "DY", "T1", "T2", "P", "ALC", "IE", "IW", "FI", "ALF", "H", "V", "MACH", "XEF");
-	printf("\n%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t", "TIME", "QCONV", "DY", "T1", "T2", "H", "V");
-	for (int i=0; i<prn.PRINT_CELLS_NUM; i++) {
-		fprintf(fout, "%5.5s%6.1lf\t", "CELL", thm->T[prn.PRINT_CELLS[i]]);
-		printf("%5.5s%6.1lf\t", "CELL", thm->T[prn.PRINT_CELLS[i]]);
-	}
-	fprintf(fout, "\n");
-	printf("\n");
+	if (configure(&solver, thm, opt, prn) != SUCCESS)
+		exit(-1);
 	thm->CURRENT_TIME = trm->BEGIN_TIME;
+	/*  :    -   . */
+	CThreadPool* pool = 0;
+	CADISolver* adi = 0;
+	CAVDStationTask* stations = 0;
+	CSurfaceMap* map = 0;
+	FILE* fmap = 0;
+	if (!ADI_X.empty()) {
+		sort(ADI_X.begin(), ADI_X.end());
+		pool = new CThreadPool();
+		adi = new CADISolver(BCone, pool);
+		stations = new CAVDStationTask(adi);
+		int MAIN = 0; /* ,      ,   . */
+		for (size_t k=0; k<ADI_X.size(); k++) {
+			thm_t* sthm = new thm_t(*thm);
+			gasdynamics_t* sgd = new gasdynamics_t(gd);
+			sgd->X = ADI_X[k];
+			AVDSolver* ssolver = new AVDSolver(sthm, trm, sgd, BCone);
+			if (configure(ssolver, sthm, opt, prn) != SUCCESS)
+				exit(-1);
+			adi->add(ADI_X[k], sthm);
+			stations->add(ssolver);
+			if (fabs(ADI_X[k]-gd.X) < fabs(ADI_X[MAIN]-gd.X))
+				MAIN = k;
+		}
+		thm = adi->station(MAIN);
+		printf("ADI: %d STATIONS, %d THREADS\n", adi->count(), pool->size());
+	}
+	/*  :   -       . */
+	if (!MAP_X.empty()) {
+		if (MAP_PHI.empty())
+			MAP_PHI.push_back(gd.PHI0);
+		pool = new CThreadPool();
+		map = new CSurfaceMap(trm, pool);
+		int MAIN = 0; /* ,      ,   . */
+		for (size_t k=0; k<MAP_X.size(); k++)
+			for (size_t j=0; j<MAP_PHI.size(); j++) {
+				thm_t* sthm = new thm_t(*thm);
+				gasdynamics_t* sgd = new gasdynamics_t(gd);
+				sgd->X = MAP_X[k];
+				sgd->PHI0 = MAP_PHI[j];
+				AVDSolver* ssolver = new AVDSolver(sthm, trm, sgd, BCone);
+				if (configure(ssolver, sthm, opt, prn) != SUCCESS)
+					exit(-1);
+				int s = map->add(MAP_X[k], MAP_PHI[j], ssolver);
+				if (fabs(MAP_X[k]-gd.X)+fabs(MAP_PHI[j]-gd.PHI0) < fabs(map->x(MAIN)-gd.X)+fabs(map->phi(MAIN)-gd.PHI0))
+					MAIN = s;
+			}
+		thm = map->station(MAIN)->model();
+		sprintf(rFilename, "%s-%s.map", iTRFilename, iTPSFilename);
+		fmap = fopen(rFilename, "wt");
+		assert(fmap != 0);
+		CSurfaceMap::printHeader(fmap);
+		printf("MAP: %d STATIONS, %d THREADS\n", map->count(), pool->size());
+	}
+	int PICARD_ITERS = 0; /*    . */
+	int PICARD_MAX = 0; /*      . */
+	double START = trm->BEGIN_TIME+prn.print_interval; /*   . */
+	long BRES_SIZE = -1; /*       . */
+	if (RESTART != 0) {
+		ckpt_t ckpt;
+		if ((checkpoint_load(RESTART, &ckpt, &solver) != SUCCESS) ||
+			(strcmp(ckpt.TR, iTRFilename) != 0) || (strcmp(ckpt.TPS, iTPSFilename) != 0) || ((ckpt.BRES_SIZE >= 0) != BINARY)) {
+			printf("[EE]: Can't restart from checkpoint %s\n", RESTART);
+			exit(-1);
+		}
+		PICARD_ITERS = ckpt.PICARD_ITERS;
+		PICARD_MAX = ckpt.PICARD_MAX;
+		BRES_SIZE = ckpt.BRES_SIZE;
+		START = ckpt.time+min(prn.print_interval, trm->END_TIME-ckpt.time);
+		/* ,    ,   . */
+		if ((ftruncate(fileno(fout), ckpt.RES_SIZE) != 0) || (fseek(fout, ckpt.RES_SIZE, SEEK_SET) != 0)) {
+			printf("[EE]: Can't restore results file %s\n", rFilename);
+			exit(-1);
+		}
+		printf("RESTART: %s AT %.2lf S\n", RESTART, thm->CURRENT_TIME);
+	}
+	vector<res_column_t> columns = result_columns(thm, prn, adi);
+	vector<double> row(columns.size());
+	CResultWriter* writer = 0;
+	if (BINARY) {
+		/*    <>-<>.bres,   -  . */
+		sprintf(rFilename, "%s-%s.bres", iTRFilename, iTPSFilename);
+		if (RESTART != 0)
+			writer = new CResultWriter(rFilename, (int)columns.size(), BRES_SIZE);
+		else
+			writer = new CResultWriter(rFilename, columns, vector<int>(prn.PRINT_CELLS, prn.PRINT_CELLS+prn.PRINT_CELLS_NUM));
+		if (!writer->isOpen())
+			exit(-1);
+	} else if (RESTART == 0)
+		print_header(fout, columns);
+	chrono::steady_clock::time_point CKPT_NEXT = chrono::steady_clock::now()+chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(CKPT_PERIOD));
+	if (CKPT != 0) {
+		signal(SIGUSR1, checkpoint_signal);
+		signal(SIGTERM, checkpoint_signal);
+	}
+	if (writer == 0) {
+		printf("\n%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t", "TIME", "QCONV", "DY", "T1", "T2", "H", "V");
+		for (int i=0; i<prn.PRINT_CELLS_NUM; i++)
+			printf("%5.5s%6.1lf\t", "CELL", thm->T[prn.PRINT_CELLS[i]]);
+		printf("\n");
+	}
 	double TIMESTEP = thm->INIT_TIMESTEP;
+	int STATUS = SUCCESS; /*    ,    . */
 	/* ---    -     --- */
-	for (double time = trm->BEGIN_TIME+prn.print_interval; (thm->CURRENT_TIME < trm->END_TIME); time += min(prn.print_interval, trm->END_TIME-time)) {
-		avdsolver_t info = solver.Solve(time);
-		double Qw = info.avd.QCONV;
-		fprintf(fout, "%7.2lf\t", info.time); printf("%7.2lf\t", info.time);
-		fprintf(fout, "%7.1lf\t", Qw/4186.8); printf("%7.1lf\t", Qw/4186.8);
-		fprintf(fout, "%7.3lf\t", thm->LDEL*1000.); printf("%7.3lf\t", thm->LDEL*1000.);
-		fprintf(fout, "%7.1lf\t", thm->TWL); printf("%7.1lf\t", thm->TWL);
-		fprintf(fout, "%7.1lf\t", thm->TWR); printf("%7.1lf\t", thm->TWR);
-		fprintf(fout, "%7.4lf\t", info.avd.P1);
-		fprintf(fout, "%7.4lf\t", info.avd.ALC);
-		fprintf(fout, "%7.1lf\t", info.avd.IE/4186.8);
-		fprintf(fout, "%7.1lf\t", info.avd.IW/4186.8);
-		fprintf(fout, "%7.2lf\t", info.phi);
-		fprintf(fout, "%7.2lf\t", info.al);
-		fprintf(fout, "%7.2lf\t", info.H/1000.); printf("%7.2lf\t", info.H/1000.);
-		fprintf(fout, "%7.1lf\t", info.V); printf("%7.1lf\t", info.V);
-		fprintf(fout, "%5.2lf\t", info.mach);
-		fprintf(fout, "%7.5lf\t", info.XEF);
-
-		for (int i=0; i<prn.PRINT_CELLS_NUM; i++) {
-			fprintf(fout, "%7.1lf\t", thm->T[prn.PRINT_CELLS[i]-1]);
-			printf("%7.1lf\t", thm->T[prn.PRINT_CELLS[i]-1]);
+	for (double time = START; (thm->CURRENT_TIME < trm->END_TIME); time += min(prn.print_interval, trm->END_TIME-time)) {
+		avdsolver_t info;
+		if (adi != 0) {
+			adi->Solve(time, ADI_STEP, stations);
+			info = stations->info[0];
+			for (int k=0; k<adi->count(); k++)
+				if (adi->station(k) == thm)
+					info = stations->info[k];
+		} else if (map != 0) {
+			map->Solve(time);
+			map->print(fmap);
+			info = map->info(0);
+			for (int k=0; k<map->count(); k++)
+				if (map->station(k)->model() == thm)
+					info = map->info(k);
+		} else
+			info = solver.Solve(time);
+		if (info.STATUS != SUCCESS) {
+			/*   :   ,   . */
+			STATUS = info.STATUS;
+			break;
 		}
-		fprintf(fout, "\n");
-		printf("\n");
+		PICARD_ITERS += info.PICARD_ITERS;
+		PICARD_MAX = max(PICARD_MAX, info.PICARD_MAX);
+		result_row(&(row[0]), info, thm, prn, adi);
+		if (writer != 0)
+			/*    ,     . */
+			writer->write(&(row[0]));
+		else {
+			print_row(fout, columns, &(row[0]));
+			printf("%7.2lf\t", info.time);
+			printf("%7.1lf\t", info.avd.QCONV/4186.8);
+			printf("%7.3lf\t", thm->LDEL*1000.);
+			printf("%7.1lf\t", thm->TWL);
+			printf("%7.1lf\t", thm->TWR);
+			printf("%7.2lf\t", info.H/1000.);
+			printf("%7.1lf\t", info.V);
+			for (int i=0; i<prn.PRINT_CELLS_NUM; i++)
+				printf("%7.1lf\t", thm->cellT(prn.PRINT_CELLS[i]-1));
+			printf("\n");
+			fflush(NULL);
+		}
+		/*     :    . */
+		if ((CKPT != 0) && ((CKPT_SIGNAL != 0) || (chrono::steady_clock::now() >= CKPT_NEXT))) {
+			ckpt_t ckpt;
+			strcpy(ckpt.TR, iTRFilename);
+			strcpy(ckpt.TPS, iTPSFilename);
+			ckpt.time = time;
+			ckpt.PICARD_ITERS = PICARD_ITERS;
+			ckpt.PICARD_MAX = PICARD_MAX;
+			ckpt.RES_SIZE = ftell(fout);
+			ckpt.BRES_SIZE = -1;
+			/*          . */
+			if (((writer != 0) && (writer->sync(&ckpt.BRES_SIZE) != SUCCESS)) || (checkpoint_save(CKPT, ckpt, solver) != SUCCESS))
+				printf("[EE]: Can't write checkpoint %s\n", CKPT);
+			else
+				printf("CHECKPOINT: %s AT %.2lf S\n", CKPT, thm->CURRENT_TIME);
+			if (CKPT_SIGNAL == SIGTERM) {
+				delete writer;
+				fclose(fout);
+				fflush(NULL);
+				exit(-1);
+			}
+			CKPT_SIGNAL = 0;
+			CKPT_NEXT = chrono::steady_clock::now()+chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(CKPT_PERIOD));
+		}
+	}
+	if ((writer != 0) && (writer->close() != SUCCESS)) {
+		printf("[EE]: Can't write results file %s\n", rFilename);
+		exit(-1);
+	}
+	delete writer;
+	if (STATUS != SUCCESS) {
+		fclose(fout);
 		fflush(NULL);
+		exit(-1);
+	}
+	if (opt.PICARD_TOL > 0.) {
+		fprintf(fout, "\nPICARD ITERATIONS: %d (MAX PER STAGE: %d)\n", PICARD_ITERS, PICARD_MAX);
+		printf("PICARD ITERATIONS: %d (MAX PER STAGE: %d)\n", PICARD_ITERS, PICARD_MAX);
+	}
+	if (opt.MEMO_DT > 0.) {
+		/*      . */
+		long HITS = solver.memo().HITS;
+		long CALLS = solver.memo().CALLS;
+		for (size_t k=0; (stations != 0) && (k<stations->solver.size()); k++) {
+			HITS += stations->solver[k]->memo().HITS;
+			CALLS += stations->solver[k]->memo().CALLS;
+		}
+		for (int k=0; (map != 0) && (k<map->count()); k++) {
+			HITS += map->station(k)->memo().HITS;
+			CALLS += map->station(k)->memo().CALLS;
+		}
+		fprintf(fout, "\nMEMO HITS: %ld OF %ld STEPS (%.1lf%%)\n", HITS, CALLS, (CALLS > 0) ? 100.*HITS/CALLS : 0.);
+		printf("MEMO HITS: %ld OF %ld STEPS (%.1lf%%)\n", HITS, CALLS, (CALLS > 0) ? 100.*HITS/CALLS : 0.);
 	}
 	fclose(fout);
+	if (fmap != 0)
+		fclose(fmap);
 //	solver.print();
 	fflush(NULL);
 	system("pause");
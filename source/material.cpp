@@ -12,6 +12,23 @@ char* CMaterial::name()
 	return this->Name;
 }
 
+void CMaterial::props(const double* T, double* l, double* c, double* r, int n)
+{
+	for (int i=0; i<n; i++) {
+		l[i] = this->l(T[i]);
+		c[i] = this->c(T[i]);
+		r[i] = this->r(T[i]);
+	}
+}
+
+double CMaterial::heatQuantity(const double* T, const double* w, int n)
+{
+	double sum = 0.;
+	for (int i=0; i<n; i++)
+		sum += w[i]*heatQuantity(T[i]);
+	return sum;
+}
+
 ConstMaterial::ConstMaterial(const char* title, FILE* flog, double L, double RHO, double CP, double EPS,
 		double Tdestr, double A, double B, int Type) : CMaterial(title, flog)
 {
@@ -61,6 +78,21 @@ double ConstMaterial::heatQuantity(double T)
 {
 	return RHO*CP*T;
 }
+void ConstMaterial::props(const double* T, double* l, double* c, double* r, int n)
+{
+	for (int i=0; i<n; i++) {
+		l[i] = L;
+		c[i] = CP;
+		r[i] = RHO;
+	}
+}
+double ConstMaterial::heatQuantity(const double* T, const double* w, int n)
+{
+	double sum = 0.;
+	for (int i=0; i<n; i++)
+		sum += w[i]*T[i];
+	return RHO*CP*sum;
+}
 int ConstMaterial::check()
 {
 	if (L <= 0.)
@@ -96,22 +128,61 @@ CUserMaterial::CUserMaterial(  const char* title, FILE* flog, double L, double R
 	fTdestr.count = 0;
 	fA.count = 0;
 	fB.count = 0;
+	uL.ab = 0;
+	uRHO.ab = 0;
+	uCP.ab = 0;
+	uEPS.ab = 0;
+	hCP.abc = 0;
+}
+/** Free the copy of a property table. */
+static void table_free(func_points_t* table)
+{
+	if (table->count > 0) {
+		free(table->x);
+		free(table->y);
+		table->count = 0;
+	}
+}
+CUserMaterial::~CUserMaterial()
+{
+	func_points_t* f[] = {&fL, &fRHO, &fCP, &fEPS, &fTdestr, &fA, &fB};
+	for (size_t i=0; i<sizeof(f)/sizeof(f[0]); i++)
+		table_free(f[i]);
+	free(uL.ab);
+	free(uRHO.ab);
+	free(uCP.ab);
+	free(uEPS.ab);
+	free(hCP.abc);
 }
 int CUserMaterial::update(const char* prm, const func_points_t *table)
 {
+	double err;
+
+	/* A property set again replaces its tables. */
 	if (strcmp(prm, "L") == 0) {
+		table_free(&fL);
 		func_points_cpy(table, &fL);
+		err = utable_build(&fL, &uL);
 	} else
 	if (strcmp(prm, "CP") == 0) {
+		table_free(&fCP);
 		func_points_cpy(table, &fCP);
+		err = utable_build(&fCP, &uCP);
+		qtable_build(&uCP, &hCP);
 	} else
 	if (strcmp(prm, "RHO") == 0) {
+		table_free(&fRHO);
 		func_points_cpy(table, &fRHO);
+		err = utable_build(&fRHO, &uRHO);
 	} else
 	if (strcmp(prm, "EPS") == 0) {
+		table_free(&fEPS);
 		func_points_cpy(table, &fEPS);
+		err = utable_build(&fEPS, &uEPS);
 	} else
 		return NULL_VALUE;
+	if ((err > UTABLE_TOL) && (flog != 0))
+		fprintf(flog, "[WW] %s: %s table resampled with relative error %E\n", name(), prm, err);
 	return SUCCESS;
 }
 int CUserMaterial::check()
@@ -129,14 +200,14 @@ int CUserMaterial::check()
 double CUserMaterial::l(double T)
 {
 	if (fL.count != 0)
-		return in_LinearFunc(&fL, T);
+		return utable_val(&uL, T);
 	else
 		return ConstMaterial::l(T);
 }
 double CUserMaterial::c(double T)
 {
 	if (fCP.count != 0)
-		return in_LinearFunc(&fCP, T);
+		return utable_val(&uCP, T);
 	else
 		return ConstMaterial::c(T);
 
@@ -144,7 +215,7 @@ double CUserMaterial::c(double T)
 double CUserMaterial::r(double T)
 {
 	if (fRHO.count != 0)
-		return in_LinearFunc(&fRHO, T);
+		return utable_val(&uRHO, T);
 	else
 		return ConstMaterial::r(T);
 
@@ -152,7 +223,7 @@ double CUserMaterial::r(double T)
 double CUserMaterial::eps(double T)
 {
 		if (fEPS.count != 0)
-		return in_LinearFunc(&fEPS, T);
+		return utable_val(&uEPS, T);
 	else
 		return ConstMaterial::eps(T);
 }
@@ -181,11 +252,110 @@ int CUserMaterial::at(void)
 double CUserMaterial::heatQuantity(double T)
 {
 	if (fCP.count != 0)
-		return r(T)*ma_integral(&fCP, T);
+		return r(T)*qtable_val(&hCP, T);
 	else
 		return ConstMaterial::heatQuantity(T);
 }
+void CUserMaterial::props(const double* T, double* l, double* c, double* r, int n)
+{
+	/* Each property is a separate loop without calls: the lookups vectorize. */
+	if (fL.count != 0)
+		for (int i=0; i<n; i++)
+			l[i] = utable_val(&uL, T[i]);
+	else
+		for (int i=0; i<n; i++)
+			l[i] = ConstMaterial::l(T[i]);
+	if (fCP.count != 0)
+		for (int i=0; i<n; i++)
+			c[i] = utable_val(&uCP, T[i]);
+	else
+		for (int i=0; i<n; i++)
+			c[i] = ConstMaterial::c(T[i]);
+	if (fRHO.count != 0)
+		for (int i=0; i<n; i++)
+			r[i] = utable_val(&uRHO, T[i]);
+	else
+		for (int i=0; i<n; i++)
+			r[i] = ConstMaterial::r(T[i]);
+}
+double CUserMaterial::heatQuantity(const double* T, const double* w, int n)
+{
+	if (fCP.count == 0)
+		return ConstMaterial::heatQuantity(T, w, n);
+	double sum = 0.;
+	if (fRHO.count != 0)
+		for (int i=0; i<n; i++)
+			sum += w[i]*utable_val(&uRHO, T[i])*qtable_val(&hCP, T[i]);
+	else
+		for (int i=0; i<n; i++)
+			sum += w[i]*ConstMaterial::r(T[i])*qtable_val(&hCP, T[i]);
+	return sum;
+}
 void CUserMaterial::print(FILE *out)
 {
 
 }
+CScaledMaterial::CScaledMaterial(CMaterial* M, double KL, double KCP, double KRHO, double KEPS, double KA, double KB)
+: CMaterial(M->name(), 0)
+{
+	this->M = M;
+	this->KL = KL;
+	this->KCP = KCP;
+	this->KRHO = KRHO;
+	this->KEPS = KEPS;
+	this->KA = KA;
+	this->KB = KB;
+}
+double CScaledMaterial::l(double T)
+{
+	return KL*M->l(T);
+}
+double CScaledMaterial::c(double T)
+{
+	return KCP*M->c(T);
+}
+double CScaledMaterial::r(double T)
+{
+	return KRHO*M->r(T);
+}
+double CScaledMaterial::eps(double T)
+{
+	return KEPS*M->eps(T);
+}
+double CScaledMaterial::a(double T)
+{
+	return KA*M->a(T);
+}
+double CScaledMaterial::b(double T)
+{
+	return KB*M->b(T);
+}
+double CScaledMaterial::Td(double T)
+{
+	return M->Td(T);
+}
+int CScaledMaterial::at(void)
+{
+	return M->at();
+}
+double CScaledMaterial::heatQuantity(double T)
+{
+	return KCP*KRHO*M->heatQuantity(T);
+}
+void CScaledMaterial::props(const double* T, double* l, double* c, double* r, int n)
+{
+	M->props(T, l, c, r, n);
+	for (int i=0; i<n; i++) {
+		l[i] *= KL;
+		c[i] *= KCP;
+		r[i] *= KRHO;
+	}
+}
+double CScaledMaterial::heatQuantity(const double* T, const double* w, int n)
+{
+	return KCP*KRHO*M->heatQuantity(T, w, n);
+}
+void CScaledMaterial::print(FILE *out)
+{
+	M->print(out);
+}
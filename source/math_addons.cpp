@@ -220,134 +220,101 @@ int func_points_cpy(const func_points_t* src, func_points_t* dst) {
 	}
 	return 0;
 }
-IFunc::IFunc()
+/** Заполнить равномерную таблицу с шагом h значениями линейной интерполяции. */
+static void utable_fill(const func_points_t* points, utable_t* table, double h)
 {
-}
-void IFunc::add(double valX, double valF)
-{
-	func_t* t = new func_t;
-	t->valX = valX;
-	t->valF = valF;
-	func1D.push_back(t);
-}
-double IFunc::val(double x)
-{
-	assert(func1D.size() > 0);
-	if ((func1D[0]->valX-x)*(func1D[func1D.size()-1]->valX-x) >= 0.) // Значение выходит за границу диапазона интерполяции
-		if (fabs(func1D[0]->valX-x) < fabs(func1D[func1D.size()-1]->valX-x))
-			return func1D[0]->valF;
-		else
-			return func1D[func1D.size()-1]->valF;
-	if (func1D.size() == 1)
-		return func1D[0]->valX;
-	for (int i=1; i<(int)func1D.size(); i++) {
-//		printf("\nVX=%lf\t", func1D[i]->valX);
-		if ((func1D[i]->valX-x)*(func1D[i-1]->valX-x) <= 0.) {
-//			printf("x=%lf valX=%lf valX2=%lf i=%d\n", x, func1D[i-1]->valX, func1D[i]->valX, i);
-			double P1, P2, valX1, valX2;
-			P1 = func1D[i-1]->valF;
-			valX1 = func1D[i-1]->valX;
-			P2 = func1D[i]->valF;
-			valX2 = func1D[i]->valX;
-			return P1 + (P2-P1)*(x-valX1)/(valX2-valX1);
-		}
+	table->count = max(1, (int)floor((table->xmax - table->xmin)/h + 0.5));
+	h = (table->xmax - table->xmin)/table->count;
+	table->inv = (h > 0.) ? 1./h : 0.;
+	table->ab = (double *)realloc(table->ab, 2*table->count*sizeof(double));
+	double x0 = table->xmin;
+	double y0 = in_LinearFunc(points, x0);
+	for (int i=0; i<table->count; i++) {
+		double x1 = (i == table->count-1) ? table->xmax : table->xmin + (i+1)*h;
+		double y1 = in_LinearFunc(points, x1);
+		double k = (x1 > x0) ? (y1-y0)/(x1-x0) : 0.;
+		table->ab[2*i] = y0 - k*x0;
+		table->ab[2*i+1] = k;
+		x0 = x1;
+		y0 = y1;
 	}
-	assert(0);
-	return 0;
-}
-void IFunc::print()
-{
-	printf("X=\t");
-	for (int i=0; i<(int)func1D.size(); i++)
-		printf("%11.5lf\t", func1D[i]->valX);
-	printf("\nF=\t");
-	for (int i=0; i<(int)func1D.size(); i++)
-		printf("%11.5lf\t", func1D[i]->valF);
-	printf("\n");
 }
-IFunc::~IFunc()
-{
-	func1D.clear();
-}
-ITable::ITable()
-{
-}
-void ITable::add(IFunc* func, double valY)
-{
-	assert(func != 0);
-	table_t *t = new table_t;
-	t->func = func;
-	t->valY = valY;
-	func2D.push_back(t);
-}
-double ITable::val(double x, double y)
+
+double utable_build(const func_points_t* points, utable_t* table, double tol)
 {
-	assert(func2D.size() > 0);
-//	printf("x=%lf y=%lf %lf %lf\n", x,y, func2D[0]->valY, func2D[func2D.size()-1]->valY);
-	if ((func2D[0]->valY-y)*(func2D[func2D.size()-1]->valY-y) >= 0.) {
-		if (fabs(func2D[0]->valY-y) < fabs(func2D[func2D.size()-1]->valY-y))
-			return func2D[0]->func->val(x);
-		else
-			return func2D[func2D.size()-1]->func->val(x);
-	}
-//	assert(func2D[func2D.size()-1]->valY >= y);
+	assert(points != 0);
+	assert(points->count > 0);
+	assert(table != 0);
+	const int n = points->count;
+	double ymax = 0.;
 	
-	if (func2D.size() == 1)
-		return func2D[0]->func->val(x);
-//	printf("START\n");
-	for (int i=1; i<(int)func2D.size(); i++)
-		if ((func2D[i]->valY - y)*(func2D[i-1]->valY - y) <= 0.) {
-			double P1, P2, valY1, valY2;
-			P1 = func2D[i-1]->func->val(x);
-			valY1 = func2D[i-1]->valY;
-			P2 = func2D[i]->func->val(x);
-			valY2 = func2D[i]->valY;
-//			printf("valY1=%lf valY2=%lf P1=%lf P2=%lf i=%d\n", valY1, valY2, P1, P2, i);
-			return P1 + (P2-P1)*(y-valY1)/(valY2-valY1);
+	table->xmin = points->x[0];
+	table->xmax = points->x[n-1];
+	for (int i=0; i<n; i++)
+		ymax = max(ymax, fabs(points->y[i]));
+	/* Наибольший общий делитель расстояний между узлами. */
+	const double range = table->xmax - table->xmin;
+	double h = range;
+	for (int i=1; (i<n) && (h > 0.); i++) {
+		double a = points->x[i] - points->x[0];
+		double b = h;
+		while (b > 1.0E-9*range) {
+			double r = fmod(a, b);
+			if (b - r <= 1.0E-9*range)
+				r = 0.;
+			a = b;
+			b = r;
 		}
-	assert(0);
-	return 0;
-}
-ITable::~ITable()
-{
-	func2D.clear();
-}
-ICube::ICube()
-{
-}
-void ICube::add(ITable* tbl, double valZ)
-{
-	assert(tbl != 0);
-	cube_t *t = new cube_t;
-	t->func = tbl;
-	t->valZ = valZ;
-	func3D.push_back(t);
-}
-double ICube::val(double x, double y, double z)
-{
-	assert(func3D.size() > 0);
-	if (func3D[0]->valZ > z) {
-		for (int i=0; i<(int)func3D.size(); i++)
-			printf("valZ %d=%lf", i, func3D[i]->valZ);
-		printf("\n");
+		h = a;
 	}
-	assert((func3D[0]->valZ <= z) || (!printf("z=%lf (func3D[0]->valZ=%lf func3D.size() = %ld\n", z, func3D[0]->valZ, func3D.size())));
-	assert(func3D[func3D.size()-1]->valZ >= z);
-	if (func3D.size() == 1)
-		return func3D[0]->func->val(x, y);
-	for (int i=1; i<(int)func3D.size(); i++)
-		if (func3D[i]->valZ >= z) {
-			double P1, P2, valZ1, valZ2;
-			P1 = func3D[i-1]->func->val(x, y);
-			valZ1 = func3D[i-1]->valZ;
-			P2 = func3D[i]->func->val(x, y);
-			valZ2 = func3D[i]->valZ;
-			return P1 + (P2-P1)*(z-valZ1)/(valZ2-valZ1);
-		}
-	assert(0);
-	return 0;
+	if ((h <= 0.) || (range/h > UTABLE_MAX_CELLS)) {
+		/* Шаг - наименьшее расстояние между узлами. */
+		h = range;
+		for (int i=1; i<n; i++)
+			if (points->x[i] > points->x[i-1])
+				h = min(h, points->x[i] - points->x[i-1]);
+	}
+	/* Погрешность кусочно-линейной таблицы максимальна в узлах исходной таблицы. */
+	double err;
+	for (;;) {
+		utable_fill(points, table, h);
+		err = 0.;
+		for (int i=0; i<n; i++)
+			err = max(err, fabs(utable_val(table, points->x[i]) - points->y[i]));
+		err = (ymax > 0.) ? err/ymax : 0.;
+		if ((err <= tol) || (2*table->count > UTABLE_MAX_CELLS))
+			break;
+		h /= 2.;
+	}
+	return err;
 }
-ICube::~ICube()
+
+void qtable_build(const utable_t* f, qtable_t* F)
 {
-	func3D.clear();
+	assert(f != 0);
+	assert(F != 0);
+	assert(f->count > 0);
+	const double h = (f->xmax - f->xmin)/f->count;
+
+	F->xmin = f->xmin;
+	F->xmax = f->xmax;
+	F->inv = f->inv;
+	F->count = f->count;
+	F->abc = (double *)realloc(F->abc, 3*F->count*sizeof(double));
+	F->ylo = utable_val(f, f->xmin);
+	F->yhi = utable_val(f, f->xmax);
+	/* Интеграл от 0 до xmin функции, постоянной левее диапазона. */
+	double P = F->ylo*f->xmin;
+	double x0 = f->xmin;
+	for (int i=0; i<F->count; i++) {
+		double a = f->ab[2*i];
+		double b = f->ab[2*i+1];
+		double x1 = (i == F->count-1) ? f->xmax : f->xmin + (i+1)*h;
+		F->abc[3*i] = P - a*x0 - 0.5*b*x0*x0;
+		F->abc[3*i+1] = a;
+		F->abc[3*i+2] = 0.5*b;
+		P += a*(x1-x0) + 0.5*b*(x1*x1-x0*x0);
+		x0 = x1;
+	}
+	F->Fhi = P;
 }
@@ -1,5 +1,8 @@
 #include <model.h>
+#include <checkpoint.h>
 #include <cstring>
+#include <climits>
+#include <algorithm>
 
 thm_t::thm_t()
 {
@@ -12,23 +15,105 @@ thm_t::thm_t()
 	TWR = NULL_VALUE;
 	LBC = 0;
 	RBC = 0;
+	mid = 0;
+	T = 0;
+	width = 0;
+	CAPACITY = 0;
+	ABLATED = 0;
+	MOVED = false;
+}
+thm_t::thm_t(const thm_t& thm)
+{
+	mid = 0;
+	T = 0;
+	width = 0;
+	CAPACITY = 0;
+	lcnum = -1;
+	fcnum = -1;
+	*this = thm;
+}
+thm_t& thm_t::operator=(const thm_t& thm)
+{
+	if (this == &thm)
+		return *this;
+	reserve(thm.CAPACITY);
+	LBC = thm.LBC;
+	RBC = thm.RBC;
+	fcnum = thm.fcnum;
+	lcnum = thm.lcnum;
+	LDEL = thm.LDEL;
+	PrimaryLeftCellSize = thm.PrimaryLeftCellSize;
+	PrimaryRightCellSize = thm.PrimaryRightCellSize;
+	INIT_TIMESTEP = thm.INIT_TIMESTEP;
+	CURRENT_TIME = thm.CURRENT_TIME;
+	TWL = thm.TWL;
+	TWR = thm.TWR;
+	X0 = thm.X0;
+	TA = thm.TA;
+	ABLATED = thm.ABLATED;
+	MOVED = thm.MOVED;
+	materials = thm.materials;
+	layers = thm.layers;
+	if (lcnum >= 0) {
+		memcpy(mid, thm.mid, (lcnum+1)*sizeof(unsigned char));
+		memcpy(T, thm.T, (lcnum+1)*sizeof(double));
+		memcpy(width, thm.width, (lcnum+1)*sizeof(double));
+	}
+	return *this;
+}
+void thm_t::reserve(int cells)
+{
+	if (cells <= CAPACITY)
+		return;
+	CArena a;
+	a.reserve(2*CArena::align(cells*sizeof(double))+CArena::align(cells*sizeof(unsigned char)));
+	double* newT = a.alloc<double>(cells);
+	double* newWidth = a.alloc<double>(cells);
+	unsigned char* newMid = a.alloc<unsigned char>(cells);
+	if (lcnum >= 0) {
+		memcpy(newT, T, (lcnum+1)*sizeof(double));
+		memcpy(newWidth, width, (lcnum+1)*sizeof(double));
+		memcpy(newMid, mid, (lcnum+1)*sizeof(unsigned char));
+	}
+	arena.swap(a);
+	T = newT;
+	width = newWidth;
+	mid = newMid;
+	CAPACITY = cells;
+}
+int thm_t::capacity() const
+{
+	return CAPACITY;
 }
 int thm_t::add(int Cells, double Width, CMaterial* Material, double Temp)
 {
-	if (lcnum+Cells >= CELLS_MAX_NUM)
+	if (Cells <= 0)
 		return NULL_VALUE;
+	if (lcnum+1+Cells > CAPACITY)
+		reserve(max(lcnum+1+Cells, 2*CAPACITY));
 	
 	if (fcnum == NULL_VALUE) {
 		fcnum = 0;
 		lcnum = -1;
 	}
+	/* Material index of the layer. */
+	size_t k = find(materials.begin(), materials.end(), Material)-materials.begin();
+	if (k == materials.size()) {
+		assert(k <= UCHAR_MAX);
+		materials.push_back(Material);
+	}
 	/* Init layer properties */
+	double x = (lcnum >= 0) ? X0.back()+width[lcnum]/2. : 0.;
 	for (int i = 1; i<=Cells; i++) {
 		lcnum++;
 		width[lcnum] = Width/Cells;
-		m[lcnum] = Material;
+		mid[lcnum] = (unsigned char)k;
 		T[lcnum] = Temp;
+		X0.push_back(x+width[lcnum]/2.);
+		x += width[lcnum];
 	}
+	TA.resize(X0.size());
+	index();
 	TWL = T[fcnum];
 	TWR = T[lcnum];
 	PrimaryLeftCellSize = width[fcnum];
@@ -43,12 +128,79 @@ void thm_t::setRBC(CBoundary* BC)
 {
 	this->RBC = BC;
 }
+void thm_t::setMaterial(int k, CMaterial* M)
+{
+	assert((k >= 0) && (k < (int)materials.size()));
+	materials[k] = M;
+	index();
+}
+void thm_t::save(FILE* f) const
+{
+	size_t count = materials.size();
+	ckpt_write(f, &count);
+	ckpt_write(f, &fcnum);
+	ckpt_write(f, &lcnum);
+	ckpt_write(f, &LDEL);
+	ckpt_write(f, &PrimaryLeftCellSize);
+	ckpt_write(f, &PrimaryRightCellSize);
+	ckpt_write(f, &INIT_TIMESTEP);
+	ckpt_write(f, &CURRENT_TIME);
+	ckpt_write(f, &TWL);
+	ckpt_write(f, &TWR);
+	ckpt_write(f, &ABLATED);
+	ckpt_write(f, &MOVED);
+	ckpt_write(f, T, lcnum+1);
+	ckpt_write(f, width, lcnum+1);
+	ckpt_write(f, mid, lcnum+1);
+	ckpt_write(f, X0);
+	ckpt_write(f, TA);
+}
+int thm_t::load(FILE* f)
+{
+	size_t count;
+	int first, last;
+	if (!ckpt_read(f, &count) || (count != materials.size()) ||
+		!ckpt_read(f, &first) || !ckpt_read(f, &last) || (first < 0) || (last < first))
+		return NULL_VALUE;
+	reserve(last+1);
+	fcnum = first;
+	lcnum = last;
+	if (!ckpt_read(f, &LDEL) || !ckpt_read(f, &PrimaryLeftCellSize) || !ckpt_read(f, &PrimaryRightCellSize) ||
+		!ckpt_read(f, &INIT_TIMESTEP) || !ckpt_read(f, &CURRENT_TIME) || !ckpt_read(f, &TWL) || !ckpt_read(f, &TWR) ||
+		!ckpt_read(f, &ABLATED) || !ckpt_read(f, &MOVED) ||
+		!ckpt_read(f, T, lcnum+1) || !ckpt_read(f, width, lcnum+1) || !ckpt_read(f, mid, lcnum+1) ||
+		!ckpt_read(f, &X0) || !ckpt_read(f, &TA))
+		return NULL_VALUE;
+	for (int i=0; i<=lcnum; i++)
+		if (mid[i] >= count)
+			return NULL_VALUE;
+	index();
+	return SUCCESS;
+}
+void thm_t::setThickness(int k, double dx)
+{
+	assert((k >= 0) && (k < (int)layers.size()));
+	assert((fcnum == 0) && !MOVED && (dx > 0.));
+	double L = 0.;
+	for (int i=layers[k].first; i<=layers[k].last; i++)
+		L += width[i];
+	for (int i=layers[k].first; i<=layers[k].last; i++)
+		width[i] *= dx/L;
+	/* Cell centres of the initial mesh. */
+	double x = 0.;
+	for (int i=0; i<=lcnum; i++) {
+		X0[i] = x+width[i]/2.;
+		x += width[i];
+	}
+	PrimaryLeftCellSize = width[fcnum];
+	PrimaryRightCellSize = width[lcnum];
+}
 double thm_t::length() {
 	int i;
 	double len;
 
 	assert(fcnum >= 0);
-	assert((lcnum >= 0) && (lcnum < CELLS_MAX_NUM));
+	assert((lcnum >= 0) && (lcnum < CAPACITY));
 	assert((lcnum - fcnum) >= 0);
 
 	for (i=fcnum, len=0.; i<=lcnum; i++) {
@@ -101,7 +253,7 @@ int thm_t::crop(int side, double dx) {
 		assert(T2 > 0.);
 	}
 	//   .
-	while (strcmp(m[i]->name(), "Air") == 0) {
+	while (strcmp(material(i)->name(), "Air") == 0) {
 		LDEL += width[i];
 		i++;
 	}
@@ -109,11 +261,176 @@ int thm_t::crop(int side, double dx) {
 		PrimaryLeftCellSize = width[i];
 	assert(TWL > 0.);
 	assert(T2 > 0.);
+	double Tcut = T[fcnum];
 	fcnum = i;
 	LDEL += dx;
 	T[i] = T2; 
+	if (MOVED)
+		for (; (ABLATED < (int)X0.size()) && (X0[ABLATED] < LDEL); ABLATED++)
+			TA[ABLATED] = Tcut;
 	return 0;
 }
+double thm_t::thickness(int cells)
+{
+	assert((cells > 0) && (fcnum+cells-1 <= lcnum));
+	double L = 0.;
+	for (int i=fcnum; i<fcnum+cells; i++)
+		L += width[i];
+	return L;
+}
+double thm_t::recede(double dx, int cells)
+{
+	double L = thickness(cells);
+	assert((dx >= 0.) && (dx < L));
+	double k = (L-dx)/L;
+	track();
+	for (int i=fcnum; i<fcnum+cells; i++)
+		width[i] *= k;
+	LDEL += dx;
+	if (MOVED)
+		for (; (ABLATED < (int)X0.size()) && (X0[ABLATED] < LDEL); ABLATED++)
+			TA[ABLATED] = T[fcnum];
+	return k;
+}
+void thm_t::track()
+{
+	if (MOVED)
+		return;
+	/* Ablated cells keep their last temperatures. */
+	for (ABLATED=0; (ABLATED < (int)X0.size()) && (X0[ABLATED] < LDEL); ABLATED++)
+		TA[ABLATED] = T[ABLATED];
+	MOVED = true;
+}
+
+/** Minmod slope limiter. */
+static double minmod(double a, double b)
+{
+	if (a*b <= 0.)
+		return 0.;
+	return (fabs(a) < fabs(b)) ? a : b;
+}
+/**
+ * @brief Temperature of the material with given heat quantity.
+ * @param M - material.
+ * @param H - heat quantity per unit volume, [J/m^3].
+ * @param T - initial approximation, [K].
+ */
+static double heatTemperature(CMaterial* M, double H, double T)
+{
+	for (int k=0; k<3; k++)
+		T += (H-M->heatQuantity(T))/(M->r(T)*M->c(T));
+	return T;
+}
+int thm_t::remesh(const remesh_t& prefs)
+{
+	assert(prefs.WMIN > 0.);
+	assert(prefs.WMAX > 2.*prefs.WMIN);
+	assert(prefs.DT_COARSEN <= prefs.DT_REFINE/2.);
+	assert(prefs.NMAX > 0);
+	assert((fcnum >= 0) && (lcnum > fcnum));
+	track();
+	const int N = lcnum-fcnum+1;
+	const int cells = max(CAPACITY, max(N, prefs.NMAX));
+	/* The receded model is allowed as many cells as the initial mesh had over its thickness. */
+	const double L = thickness(N);
+	const int NMAX = (int)ceil(prefs.NMAX*L/(L+LDEL));
+	size_t bytes = 2*CArena::align(cells*sizeof(double))+CArena::align(cells*sizeof(unsigned char));
+	if (spare.size() < bytes)
+		spare.reserve(bytes);
+	else
+		spare.reset();
+	double* nT = spare.alloc<double>(cells);
+	double* nW = spare.alloc<double>(cells);
+	unsigned char* nM = spare.alloc<unsigned char>(cells);
+	int n = 0;
+	for (int i=fcnum; i<=lcnum; i++) {
+		CMaterial* M = material(i);
+		double Tl = (i > fcnum) ? T[i-1] : TWL;
+		double Tr = (i < lcnum) ? T[i+1] : T[i];
+		double jump = max(fabs(T[i]-Tl), fabs(Tr-T[i]));
+		/* The cells written, the halves and the cells left stay within NMAX. */
+		if ((jump > prefs.DT_REFINE) && (width[i] >= 2.*prefs.WMIN) && (n+2+lcnum-i <= NMAX)) {
+			/* Split the cell with the limited linear profile. */
+			double d = 0.25*minmod(T[i]-Tl, Tr-T[i]);
+			double Tl2 = T[i]-d;
+			double Tr2 = T[i]+d;
+			/* Correct the halves to keep heat quantity of the cell. */
+			double dH = 2.*M->heatQuantity(T[i])-M->heatQuantity(Tl2)-M->heatQuantity(Tr2);
+			double dT = dH/(M->r(Tl2)*M->c(Tl2)+M->r(Tr2)*M->c(Tr2));
+			nT[n] = Tl2+dT; nW[n] = width[i]/2.; nM[n++] = mid[i];
+			nT[n] = Tr2+dT; nW[n] = width[i]/2.; nM[n++] = mid[i];
+			continue;
+		}
+		if ((i < lcnum) && (mid[i] == mid[i+1]) && (width[i]+width[i+1] <= prefs.WMAX) &&
+				(fabs(T[i+1]-T[i]) < prefs.DT_COARSEN)) {
+			/* Merge the pair of cells if the merged cell has small jumps to its neighbours. */
+			double w = width[i]+width[i+1];
+			double H = (width[i]*M->heatQuantity(T[i])+width[i+1]*M->heatQuantity(T[i+1]))/w;
+			double Tm = heatTemperature(M, H, (width[i]*T[i]+width[i+1]*T[i+1])/w);
+			Tl = (n > 0) ? nT[n-1] : TWL;
+			Tr = (i+1 < lcnum) ? T[i+2] : Tm;
+			if ((fabs(Tm-Tl) < prefs.DT_COARSEN) && (fabs(Tr-Tm) < prefs.DT_COARSEN)) {
+				nT[n] = Tm; nW[n] = w; nM[n++] = mid[i];
+				i++;
+				continue;
+			}
+		}
+		nT[n] = T[i]; nW[n] = width[i]; nM[n++] = mid[i];
+	}
+	arena.swap(spare);
+	T = nT;
+	width = nW;
+	mid = nM;
+	CAPACITY = cells;
+	fcnum = 0;
+	lcnum = n-1;
+	index();
+	PrimaryLeftCellSize = max(PrimaryLeftCellSize, width[0]);
+	return n;
+}
+void thm_t::reserve(const remesh_t& prefs)
+{
+	assert(prefs.WMIN > 0.);
+	assert((fcnum >= 0) && (lcnum >= fcnum));
+	assert(prefs.NMAX > 0);
+	reserve(max(lcnum-fcnum+1, prefs.NMAX));
+	size_t bytes = 2*CArena::align(CAPACITY*sizeof(double))+CArena::align(CAPACITY*sizeof(unsigned char));
+	if (spare.size() < bytes)
+		spare.reserve(bytes);
+}
+void thm_t::index()
+{
+	layers.clear();
+	for (int i=0; i<=lcnum; i++) {
+		if (layers.empty() || (mid[i] != mid[i-1])) {
+			layer_t layer;
+			layer.first = i;
+			layer.M = material(i);
+			layers.push_back(layer);
+		}
+		layers.back().last = i;
+	}
+}
+double thm_t::cellT(int cell)
+{
+	assert((cell >= 0) && (cell < (int)X0.size()));
+	if (!MOVED)
+		return T[cell];
+	if (cell < ABLATED)
+		return TA[cell];
+	/* Linear interpolation between the cell centres. */
+	double x = X0[cell]-LDEL;
+	double xc = width[fcnum]/2.;
+	if (x <= xc)
+		return in_linear(0., TWL, xc, T[fcnum], x);
+	for (int i=fcnum; i<lcnum; i++) {
+		double xn = xc+(width[i]+width[i+1])/2.;
+		if (x <= xn)
+			return in_linear(xc, T[i], xn, T[i+1], x);
+		xc = xn;
+	}
+	return T[lcnum];
+}
 
 void thm_t::setTemperature(func_points_t * Tf)
 {
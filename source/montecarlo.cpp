@@ -0,0 +1,182 @@
+#include <montecarlo.h>
+#include <cstring>
+
+/** Names of the parameters: factors of the material properties and heat flux, offsets of the trajectory. */
+static const char* MC_NAMES[] = {"LAYER_L", "LAYER_CP", "LAYER_D", "LAYER_EPS", "LAYER_A", "LAYER_B", "Q", "H", "V", "AL"};
+enum {MC_L, MC_CP, MC_D, MC_EPS, MC_A, MC_B, MC_Q, MC_H, MC_V, MC_AL, MC_TARGETS};
+
+/** Finalizer of SplitMix64: bijective mixing of a 64-bit counter. */
+static uint64_t mc_mix(uint64_t z)
+{
+	z += 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/** Uniform number in (0, 1) for the counter (seed, realisation, stream). */
+static double mc_uniform(uint64_t seed, uint64_t n, uint64_t stream)
+{
+	uint64_t x = mc_mix(seed ^ mc_mix(n ^ mc_mix(stream)));
+	return ((double)(x >> 11)+0.5)/9007199254740992.;
+}
+
+CMonteCarlo::CMonteCarlo(const char* filename, uint64_t seed)
+{
+	char line[STRING_MAX_LEN];
+	SEED = seed;
+	FILE* f = fopen(filename, "rt");
+	if (f == 0) {
+		printf("[EE]: Can't open uncertain parameters %s\n", filename);
+		exit(-1);
+	}
+	while (fgets(line, STRING_MAX_LEN, f) != 0) {
+		char name[STRING_MAX_LEN], dist[STRING_MAX_LEN];
+		mc_param_t p;
+		char* comment = strchr(line, '#');
+		if (comment != 0)
+			*comment = 0;
+		int n = sscanf(line, "%s %s %lf %lf", name, dist, &p.A, &p.B);
+		if (n <= 0)
+			continue;
+		char* material = strchr(name, ':');
+		p.MATERIAL = 0;
+		if (material != 0) {
+			*(material++) = 0;
+			p.MATERIAL = atoi(material);
+		}
+		for (p.TARGET=0; (p.TARGET < MC_TARGETS) && (strcmp(name, MC_NAMES[p.TARGET]) != 0); p.TARGET++);
+		if (strcmp(dist, "normal") == 0)
+			p.DIST = MC_NORMAL;
+		else if (strcmp(dist, "uniform") == 0)
+			p.DIST = MC_UNIFORM;
+		else
+			p.DIST = NULL_VALUE;
+		if ((n != 4) || (p.TARGET == MC_TARGETS) || (p.DIST == NULL_VALUE) ||
+			((material != 0) && ((p.TARGET > MC_B) || (p.MATERIAL <= 0))) ||
+			((p.DIST == MC_NORMAL) && (p.B < 0.)) || ((p.DIST == MC_UNIFORM) && (p.B < p.A)) ||
+			(params.size() == MC_PARAMS_MAX)) {
+			printf("[EE]: Incorrect uncertain parameter in %s: %s\n", filename, line);
+			exit(-1);
+		}
+		params.push_back(p);
+		/* Factors can't reach zero: the properties and flux must stay positive. */
+		if ((p.TARGET <= MC_Q) && (lower(count()-1) <= 0.)) {
+			printf("[EE]: Factor of uncertain parameter can be zero or negative in %s: %s\n", filename, line);
+			exit(-1);
+		}
+	}
+	fclose(f);
+	if (params.empty()) {
+		printf("[EE]: No uncertain parameters in %s\n", filename);
+		exit(-1);
+	}
+}
+
+int CMonteCarlo::count() const
+{
+	return (int)params.size();
+}
+
+const mc_param_t& CMonteCarlo::param(int k) const
+{
+	assert((k >= 0) && (k < count()));
+	return params[k];
+}
+
+void CMonteCarlo::name(int k, char* name) const
+{
+	assert((k >= 0) && (k < count()));
+	if (params[k].MATERIAL > 0)
+		sprintf(name, "%s:%d", MC_NAMES[params[k].TARGET], params[k].MATERIAL);
+	else
+		strcpy(name, MC_NAMES[params[k].TARGET]);
+}
+
+double CMonteCarlo::lower(int k) const
+{
+	assert((k >= 0) && (k < count()));
+	if (params[k].DIST == MC_NORMAL)
+		return params[k].A-MC_SIGMAS*params[k].B;
+	return params[k].A;
+}
+
+int CMonteCarlo::check(const thm_t* thm, const trm_t* trm) const
+{
+	double H = trm->H.min();
+	double V = trm->V.min();
+	for (int k=0; k<count(); k++) {
+		if (params[k].MATERIAL > (int)thm->materials.size())
+			return NULL_VALUE;
+		if (params[k].TARGET == MC_H)
+			H += lower(k);
+		else if (params[k].TARGET == MC_V)
+			V += lower(k);
+	}
+	return ((H < 0.) || (V < 0.)) ? NULL_VALUE : SUCCESS;
+}
+
+void CMonteCarlo::sample(long n, double* values) const
+{
+	for (int k=0; k<count(); k++) {
+		const mc_param_t& p = params[k];
+		/* Each parameter has two streams of its own, redraws take the next pairs. */
+		double u1 = mc_uniform(SEED, n, 2*k);
+		double u2 = mc_uniform(SEED, n, 2*k+1);
+		if (p.DIST == MC_NORMAL) {
+			double z = sqrt(-2.*log(u1))*cos(2.*M_PI*u2);
+			for (int r=1; (fabs(z) > MC_SIGMAS) && (r < MC_REDRAWS_MAX); r++) {
+				u1 = mc_uniform(SEED, n, 2*(r*MC_PARAMS_MAX+k));
+				u2 = mc_uniform(SEED, n, 2*(r*MC_PARAMS_MAX+k)+1);
+				z = sqrt(-2.*log(u1))*cos(2.*M_PI*u2);
+			}
+			values[k] = p.A+p.B*max(-MC_SIGMAS, min(MC_SIGMAS, z));
+		} else
+			values[k] = p.A+(p.B-p.A)*u1;
+	}
+}
+
+/**
+ * @brief Combined factor of the parameters of one name.
+ * @param material - material number, 1...materials (0 - parameters of all materials only).
+ */
+static double mc_factor(const CMonteCarlo& mc, const double* values, int target, int material)
+{
+	double k = 1.;
+	for (int i=0; i<mc.count(); i++)
+		if ((mc.param(i).TARGET == target) && ((mc.param(i).MATERIAL == 0) || (mc.param(i).MATERIAL == material)))
+			k *= values[i];
+	return k;
+}
+
+/** Combined offset of the parameters of one name. */
+static double mc_offset(const CMonteCarlo& mc, const double* values, int target)
+{
+	double b = 0.;
+	for (int i=0; i<mc.count(); i++)
+		if (mc.param(i).TARGET == target)
+			b += values[i];
+	return b;
+}
+
+CRealisation::CRealisation(const CMonteCarlo& mc, const double* values, const trm_t* trm, const thm_t* thm, const CHeatFlux* flux)
+: trm(*trm), thm(*thm), flux(flux, mc_factor(mc, values, MC_Q, 0))
+{
+	this->trm.H.scale(1., mc_offset(mc, values, MC_H));
+	this->trm.V.scale(1., mc_offset(mc, values, MC_V));
+	this->trm.AL.scale(1., mc_offset(mc, values, MC_AL));
+	for (size_t k=0; k<thm->materials.size(); k++) {
+		CMaterial* M = new CScaledMaterial(thm->materials[k],
+			mc_factor(mc, values, MC_L, k+1), mc_factor(mc, values, MC_CP, k+1),
+			mc_factor(mc, values, MC_D, k+1), mc_factor(mc, values, MC_EPS, k+1),
+			mc_factor(mc, values, MC_A, k+1), mc_factor(mc, values, MC_B, k+1));
+		materials.push_back(M);
+		this->thm.setMaterial(k, M);
+	}
+}
+
+CRealisation::~CRealisation()
+{
+	for (size_t k=0; k<materials.size(); k++)
+		delete materials[k];
+}
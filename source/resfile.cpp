@@ -0,0 +1,195 @@
+#include <resfile.h>
+#include <cstring>
+#include <unistd.h>
+
+CResultWriter::CResultWriter(const char* filename, const vector<res_column_t>& columns, const vector<int>& cells)
+{
+	f = fopen(filename, "wb");
+	if (f == 0) {
+		printf("[EE]: Can't create results file %s\n", filename);
+		failed = true;
+		return;
+	}
+	COLUMNS = (int)columns.size();
+	assert(COLUMNS > 0);
+	int32_t n[2] = {(int32_t)columns.size(), (int32_t)cells.size()};
+	fwrite(RES_MAGIC, 1, sizeof(RES_MAGIC), f);
+	fwrite(n, sizeof(int32_t), 2, f);
+	for (size_t k=0; k<cells.size(); k++) {
+		int32_t cell = cells[k];
+		fwrite(&cell, sizeof(int32_t), 1, f);
+	}
+	for (size_t c=0; c<columns.size(); c++) {
+		fwrite(columns[c].NAME, 1, RES_NAME_LEN, f);
+		fwrite(columns[c].FORMAT, 1, RES_NAME_LEN, f);
+	}
+	start();
+}
+
+CResultWriter::CResultWriter(const char* filename, int columns, long size)
+{
+	f = fopen(filename, "r+b");
+	if ((f != 0) && ((ftruncate(fileno(f), size) != 0) || (fseek(f, size, SEEK_SET) != 0))) {
+		fclose(f);
+		f = 0;
+	}
+	if (f == 0) {
+		printf("[EE]: Can't restore results file %s\n", filename);
+		failed = true;
+		return;
+	}
+	COLUMNS = columns;
+	assert(COLUMNS > 0);
+	start();
+}
+
+void CResultWriter::start()
+{
+	buffer[0].resize(COLUMNS*RES_BLOCK_ROWS);
+	buffer[1].resize(COLUMNS*RES_BLOCK_ROWS);
+	current = 0;
+	rows = 0;
+	pending = -1;
+	prows = 0;
+	stop = false;
+	failed = false;
+	worker = thread(&CResultWriter::run, this);
+}
+
+CResultWriter::~CResultWriter()
+{
+	close();
+}
+
+bool CResultWriter::isOpen() const
+{
+	return (f != 0);
+}
+
+void CResultWriter::run()
+{
+	for (;;) {
+		unique_lock<mutex> lk(lock);
+		while (!stop && (pending < 0))
+			ready.wait(lk);
+		if (pending < 0)
+			return;
+		const double* block = &(buffer[pending][0]);
+		int32_t n = prows;
+		lk.unlock();
+		/* The buffer belongs to this thread until pending is reset. */
+		bool ok = (fwrite(&n, sizeof(int32_t), 1, f) == 1);
+		for (int c=0; c<COLUMNS; c++)
+			ok = (fwrite(block+c*RES_BLOCK_ROWS, sizeof(double), n, f) == (size_t)n) && ok;
+		ok = (fflush(f) == 0) && ok;
+		lk.lock();
+		failed = failed || !ok;
+		pending = -1;
+		written.notify_one();
+	}
+}
+
+void CResultWriter::flush()
+{
+	if (rows == 0)
+		return;
+	unique_lock<mutex> lk(lock);
+	while (pending >= 0)
+		written.wait(lk);
+	pending = current;
+	prows = rows;
+	ready.notify_one();
+	current = 1-current;
+	rows = 0;
+}
+
+void CResultWriter::write(const double* values)
+{
+	assert(f != 0);
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	if (rows == 0)
+		first = now;
+	double* block = &(buffer[current][0]);
+	for (int c=0; c<COLUMNS; c++)
+		block[c*RES_BLOCK_ROWS+rows] = values[c];
+	if ((++rows == RES_BLOCK_ROWS) || (chrono::duration<double>(now-first).count() >= RES_FLUSH_PERIOD))
+		flush();
+}
+
+int CResultWriter::sync(long* size)
+{
+	assert(f != 0);
+	flush();
+	unique_lock<mutex> lk(lock);
+	while (pending >= 0)
+		written.wait(lk);
+	*size = ftell(f);
+	return ((*size < 0) || failed) ? NULL_VALUE : SUCCESS;
+}
+
+int CResultWriter::close()
+{
+	if (f == 0)
+		return failed ? NULL_VALUE : SUCCESS;
+	flush();
+	{
+		unique_lock<mutex> lk(lock);
+		stop = true;
+	}
+	ready.notify_one();
+	worker.join();
+	failed = (fclose(f) != 0) || failed;
+	f = 0;
+	return failed ? NULL_VALUE : SUCCESS;
+}
+
+int res_convert(const char* filename, FILE* out)
+{
+	char magic[sizeof(RES_MAGIC)];
+	int32_t n[2];
+	FILE* f = fopen(filename, "rb");
+	if (f == 0)
+		return NULL_VALUE;
+	if ((fread(magic, 1, sizeof(RES_MAGIC), f) != sizeof(RES_MAGIC)) || (memcmp(magic, RES_MAGIC, sizeof(RES_MAGIC)) != 0) ||
+		(fread(n, sizeof(int32_t), 2, f) != 2) || (n[0] <= 0) || (n[1] < 0)) {
+		fclose(f);
+		return NULL_VALUE;
+	}
+	vector<int32_t> cells(n[1]+1);
+	vector<res_column_t> columns(n[0]);
+	bool ok = (fread(&(cells[0]), sizeof(int32_t), n[1], f) == (size_t)n[1]);
+	for (int c=0; ok && (c<n[0]); c++) {
+		ok = (fread(columns[c].NAME, 1, RES_NAME_LEN, f) == RES_NAME_LEN) &&
+			(fread(columns[c].FORMAT, 1, RES_NAME_LEN, f) == RES_NAME_LEN);
+		columns[c].NAME[RES_NAME_LEN-1] = 0;
+		columns[c].FORMAT[RES_NAME_LEN-1] = 0;
+		/* Format of one floating point value only. */
+		ok = ok && (columns[c].FORMAT[0] == '%') && (strchr(columns[c].FORMAT+1, '%') == 0) &&
+			(strcspn(columns[c].FORMAT, "fge") == strlen(columns[c].FORMAT)-1);
+	}
+	if (!ok) {
+		fclose(f);
+		return NULL_VALUE;
+	}
+	/* Header is the same as the text results file has. */
+	fprintf(out, "\n--- RESULTS ---\n\n");
+	for (int c=0; c<n[0]; c++)
+		fprintf(out, "%s\t", columns[c].NAME);
+	fprintf(out, "\n");
+	vector<double> block(n[0]*RES_BLOCK_ROWS);
+	int32_t rows;
+	while (ok && (fread(&rows, sizeof(int32_t), 1, f) == 1)) {
+		ok = (rows > 0) && (rows <= RES_BLOCK_ROWS);
+		for (int c=0; ok && (c<n[0]); c++)
+			ok = (fread(&(block[c*RES_BLOCK_ROWS]), sizeof(double), rows, f) == (size_t)rows);
+		for (int r=0; ok && (r<rows); r++) {
+			for (int c=0; c<n[0]; c++) {
+				fprintf(out, columns[c].FORMAT, block[c*RES_BLOCK_ROWS+r]);
+				fprintf(out, "\t");
+			}
+			fprintf(out, "\n");
+		}
+	}
+	fclose(f);
+	return ok ? SUCCESS : NULL_VALUE;
+}
@@ -0,0 +1,179 @@
+#include <sizing.h>
+#include <threadpool.h>
+#include <algorithm>
+
+/** Точность подбора толщины в долях номинальной толщины. */
+#define SIZING_TOL	(1.0E-3)
+/** Максимальная толщина при подборе в долях номинальной толщины. */
+#define SIZING_MAX	(64.)
+
+/**
+ * @brief Расчёт вариантов толщины ТЗП при подборе.
+ * @details Вариант - множитель номинальной толщины выбранных слоёв. Температура
+ * ячейки растёт при уменьшении толщины, поэтому варианты упорядочены: вариант
+ * тоньше непрошедшего не проходит, толще прошедшего - проходит. Расчёт варианта
+ * прекращается, как только температура ячейки превысит допустимую или исход
+ * варианта станет известен по соседним вариантам. Вариант, который невозможно
+ * рассчитать (например, слой уносится целиком), не проходит.
+ */
+class CSizingTask : public CTask {
+	/** Настройки решателей. */
+	const options_t& opt;
+	/** Номинальные траектория и тепловая модель. */
+	trm_t* trm;
+	thm_t* thm;
+	/** Газодинамика точки. */
+	gasdynamics_t* gd;
+	/** Геометрия ЛА. */
+	CBluntedCone* BCone;
+	/** Параметры печати. */
+	const print_t& prn;
+	/** Номера подбираемых слоёв и их номинальные толщины, м. */
+	const vector<int>& layers;
+	const vector<double>& dx;
+	/** Номер контролируемой ячейки (как в списке печатаемых ячеек). */
+	int CELL;
+	/** Допустимая температура ячейки, К. */
+	double TMAX;
+	/** Номер самого тонкого прошедшего варианта (F.size() - нет) и самого толстого непрошедшего (-1 - нет). */
+	atomic<int> PASS, FAIL;
+public:
+	/** Множители толщины вариантов, по возрастанию. */
+	vector<double> F;
+	/** Вариант проходит по температуре. */
+	vector<char> OK;
+	/** Максимальная температура ячейки до прекращения расчёта варианта, К. */
+	vector<double> TPEAK;
+	/** Вариант рассчитан до конца траектории, TPEAK - максимум за весь полёт. */
+	vector<char> FULL;
+	CSizingTask(const options_t& opt, trm_t* trm, thm_t* thm, gasdynamics_t* gd, CBluntedCone* BCone,
+		const print_t& prn, const vector<int>& layers, const vector<double>& dx, int CELL, double TMAX) :
+		opt(opt), trm(trm), thm(thm), gd(gd), BCone(BCone), prn(prn), layers(layers), dx(dx), CELL(CELL), TMAX(TMAX)
+	{
+	}
+	/** Подготовить расчёт вариантов f. */
+	void start(const vector<double>& f)
+	{
+		F = f;
+		OK.assign(F.size(), 0);
+		TPEAK.assign(F.size(), 0.);
+		FULL.assign(F.size(), 0);
+		PASS = (int)F.size();
+		FAIL = -1;
+	}
+	virtual void run(int index, int thread)
+	{
+		thm_t model(*thm);
+		for (size_t k=0; k<layers.size(); k++)
+			model.setThickness(layers[k], F[index]*dx[k]);
+		AVDSolver solver(&model, trm, gd, BCone);
+		bool ok = (configure(&solver, &model, opt, prn) == SUCCESS);
+		model.CURRENT_TIME = trm->BEGIN_TIME;
+		double T = model.cellT(CELL-1);
+		ok = ok && (T <= TMAX);
+		for (double time = trm->BEGIN_TIME+prn.print_interval; ok && (model.CURRENT_TIME < trm->END_TIME); time += min(prn.print_interval, trm->END_TIME-time)) {
+			if (FAIL >= index) {
+				ok = false;
+				break;
+			}
+			if (PASS <= index)
+				break;
+			if (solver.Solve(time).STATUS != SUCCESS) {
+				ok = false;
+				break;
+			}
+			T = max(T, model.cellT(CELL-1));
+			ok = (T <= TMAX);
+		}
+		OK[index] = ok;
+		TPEAK[index] = T;
+		FULL[index] = (model.CURRENT_TIME >= trm->END_TIME);
+		/* Исход варианта сообщается расчётам соседних вариантов. */
+		for (int k = PASS; ok && (index < k) && !PASS.compare_exchange_weak(k, index); );
+		for (int k = FAIL; !ok && (index > k) && !FAIL.compare_exchange_weak(k, index); );
+	}
+};
+
+void sizing(vector<int> layers, int CELL, double TMAX, FILE* fout, const options_t& opt,
+	trm_t* trm, thm_t* thm, gasdynamics_t* gd, CBluntedCone* BCone, const print_t& prn)
+{
+	vector<double> dx;
+	if ((CELL < 1) || (CELL > thm->lcnum+1)) {
+		printf("[EE]: Sizing cell %d is out of the model\n", CELL);
+		exit(-1);
+	}
+	for (size_t k=0; k<layers.size(); k++) {
+		if ((layers[k] < 1) || (layers[k] > (int)thm->layers.size())) {
+			printf("[EE]: Sizing layer %d is out of the model\n", layers[k]);
+			exit(-1);
+		}
+		layers[k]--;
+		double L = 0.;
+		for (int i=thm->layers[layers[k]].first; i<=thm->layers[layers[k]].last; i++)
+			L += thm->width[i];
+		dx.push_back(L);
+	}
+	CThreadPool pool;
+	CSizingTask task(opt, trm, thm, gd, BCone, prn, layers, dx, CELL, TMAX);
+	const int P = pool.size();
+	printf("SIZING: CELL %d, TMAX %.1lf K, %d THREADS\n", CELL, TMAX, P);
+	fprintf(fout, "\n--- SIZING ---\n");
+	fprintf(fout, "\nCELL: %d TMAX: %.1lf\n\n", CELL, TMAX);
+	/* Интервал множителей толщины: lo - не проходит, hi - проходит. */
+	double lo = 0., hi = NULL_VALUE;
+	/* TPEAK самого тонкого прошедшего варианта и следующий за ним рассчитанный до конца прошедший вариант (hp < 0 - нет). */
+	double Thi = 0., hp = NULL_VALUE, Tp = 0.;
+	bool isHalved = true;
+	for (int iter=1; (hi < 0.) || (hi-lo > SIZING_TOL); iter++) {
+		vector<double> f;
+		/* Секущая TPEAK двух прошедших вариантов до TMAX. */
+		double r = ((hp > 0.) && (Tp < Thi)) ? hi+(TMAX-Thi)*(hp-hi)/(Tp-Thi) : NULL_VALUE;
+		if ((hi < 0.) || (lo == 0.) || (r < 0.) || !isHalved)
+			for (int i=1; i<=P; i++)
+				f.push_back((hi < 0.) ? ((lo == 0.) ? (double)i/P : lo*pow(2., i)) : lo+(hi-lo)*i/(P+1));
+		else {
+			r = min(max(r, lo+SIZING_TOL/2.), hi-SIZING_TOL/2.);
+			if (P == 1)
+				f.push_back(r);
+			else {
+				f.push_back(r-SIZING_TOL/2.);
+				f.push_back(r+SIZING_TOL/2.);
+			}
+			for (int i=1; i<=P-2; i++)
+				f.push_back(lo+(hi-lo)*i/(P-1));
+			sort(f.begin(), f.end());
+		}
+		task.start(f);
+		pool.run(&task, P);
+		const double WIDTH = hi-lo;
+		for (int i=0; i<P; i++)
+			if (task.OK[i] && ((hi < 0.) || (task.F[i] < hi))) {
+				hp = hi;
+				Tp = Thi;
+				hi = task.F[i];
+				Thi = task.TPEAK[i];
+			} else if (task.OK[i] && task.FULL[i] && (task.F[i] > hi) && ((hp < 0.) || (task.F[i] < hp))) {
+				hp = task.F[i];
+				Tp = task.TPEAK[i];
+			} else if (!task.OK[i])
+				lo = max(lo, task.F[i]);
+		isHalved = (WIDTH < 0.) || (hi-lo <= WIDTH/2.);
+		fprintf(fout, "ITERATION %d: %.5lf...%.5lf\n", iter, lo, hi);
+		printf("ITERATION %d: %.5lf...%.5lf\n", iter, lo, hi);
+		if ((hi < 0.) && (lo >= SIZING_MAX)) {
+			printf("[EE]: Temperature of cell %d exceeds %.1lf K at %g nominal thickness\n", CELL, TMAX, SIZING_MAX);
+			exit(-1);
+		}
+	}
+	/* Температура найденного варианта без прекращения расчёта. */
+	task.start(vector<double>(1, hi));
+	pool.run(&task, 1);
+	fprintf(fout, "\n%7.7s\t%7.7s\t%7.7s\n", "LAYER", "DX0", "DX");
+	printf("\n%7.7s\t%7.7s\t%7.7s\n", "LAYER", "DX0", "DX");
+	for (size_t k=0; k<layers.size(); k++) {
+		fprintf(fout, "%7d\t%7.3lf\t%7.3lf\n", layers[k]+1, dx[k]*1000., hi*dx[k]*1000.);
+		printf("%7d\t%7.3lf\t%7.3lf\n", layers[k]+1, dx[k]*1000., hi*dx[k]*1000.);
+	}
+	fprintf(fout, "\nFACTOR: %.5lf TPEAK: %.1lf\n", hi, task.TPEAK[0]);
+	printf("\nFACTOR: %.5lf TPEAK: %.1lf\n", hi, task.TPEAK[0]);
+}
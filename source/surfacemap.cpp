@@ -0,0 +1,175 @@
+#include <surfacemap.h>
+#include <alloccount.h>
+
+/** Steps of the stations with the common free stream. */
+class CMapStepTask : public CTask {
+public:
+	CSurfaceMap* map;
+	virtual void run(int index, int thread)
+	{
+		map->Step(index);
+	}
+};
+
+CSurfaceMap::CSurfaceMap(trm_t* trm, CThreadPool* pool)
+{
+	assert(trm != 0);
+	assert(pool != 0);
+	this->trm = trm;
+	this->pool = pool;
+	TIMESTEP = STD_TIMESTEP_MIN;
+	CURSOR = 0;
+}
+
+CSurfaceMap::~CSurfaceMap()
+{
+	for (size_t g=0; g<packs.size(); g++)
+		delete packs[g];
+}
+
+int CSurfaceMap::add(double x, double phi, AVDSolver* solver)
+{
+	assert(solver != 0);
+	assert(this->solver.empty() || (solver->model()->CURRENT_TIME == this->solver[0]->model()->CURRENT_TIME));
+	if (this->solver.empty())
+		TIMESTEP = solver->timestep();
+	this->solver.push_back(solver);
+	X.push_back(x);
+	PHI.push_back(phi);
+	result.resize(this->solver.size());
+	AVDSolver::Reset(&result.back());
+	result.back().time = solver->model()->CURRENT_TIME;
+	return count()-1;
+}
+
+int CSurfaceMap::count() const
+{
+	return (int)solver.size();
+}
+
+int CSurfaceMap::groups() const
+{
+	return (count()+TDMA_LANES-1)/TDMA_LANES;
+}
+
+AVDSolver* CSurfaceMap::station(int s)
+{
+	assert((s >= 0) && (s < count()));
+	return solver[s];
+}
+
+double CSurfaceMap::x(int s) const
+{
+	assert((s >= 0) && (s < count()));
+	return X[s];
+}
+
+double CSurfaceMap::phi(int s) const
+{
+	assert((s >= 0) && (s < count()));
+	return PHI[s];
+}
+
+const avdsolver_t& CSurfaceMap::info(int s) const
+{
+	assert((s >= 0) && (s < count()));
+	return result[s];
+}
+
+void CSurfaceMap::Step(int g)
+{
+	ALLOC_MARK(allocs);
+	CTHSolverPack* pack = packs[g];
+	int lane[TDMA_LANES];
+	solve_result_t srt[TDMA_LANES];
+	double stop = 0.;
+	pack->clear();
+	for (int s=g*TDMA_LANES; s<min((g+1)*TDMA_LANES, count()); s++) {
+		thm_t* thm = solver[s]->model();
+		solver[s]->setTimestep(TIMESTEP);
+		/* The stations of the map advance together, the map can't go on without one of them. */
+		if (solver[s]->Setup(&result[s]) != SUCCESS)
+			exit(-1);
+		/* The pack takes the stations with the same stop point as its first one. */
+		if (((pack->count() == 0) || (thm->CURRENT_TIME+solver[s]->timestep() == stop)) &&
+				(pack->add(solver[s]->thermal()) != NULL_VALUE)) {
+			stop = thm->CURRENT_TIME+solver[s]->timestep();
+			lane[pack->count()-1] = s;
+		} else
+			solver[s]->Complete(&result[s], solver[s]->thermal()->Solve(thm->CURRENT_TIME+solver[s]->timestep()));
+	}
+	if (pack->count() > 0) {
+		pack->Solve(stop, srt);
+		for (int k=0; k<pack->count(); k++)
+			solver[lane[k]]->Complete(&result[lane[k]], srt[k]);
+	}
+	ALLOC_CHECK(allocs);
+}
+
+void CSurfaceMap::Solve(double time)
+{
+	assert(count() > 0);
+	thm_t* thm = solver[0]->model();
+	CMapStepTask task;
+
+	assert(time > thm->CURRENT_TIME);
+	task.map = this;
+	/* Packs are sized for the largest model before the steps. */
+	int capacity = 0;
+	for (int s=0; s<count(); s++) {
+		AVDSolver::Reset(&result[s]);
+		capacity = max(capacity, solver[s]->model()->capacity()+2);
+	}
+	for (int g=0; g<groups(); g++) {
+		if (g == (int)packs.size())
+			packs.push_back(0);
+		if ((packs[g] == 0) || (packs[g]->capacity() < capacity)) {
+			delete packs[g];
+			packs[g] = new CTHSolverPack(capacity);
+		}
+	}
+	for (; thm->CURRENT_TIME < time; ) {
+		TIMESTEP = min(TIMESTEP, time - thm->CURRENT_TIME);
+		/* Heat flux of the stations missed by their caches in one batch: the free stream part is computed once. */
+		miss.clear();
+		for (int s=0; s<count(); s++)
+			if (!solver[s]->Recall(&result[s]))
+				miss.push_back(s);
+		if (!miss.empty()) {
+			AVDSolver::Flow(trm, thm->CURRENT_TIME, &flow, &CURSOR);
+			avd_resize(&batch, (int)miss.size());
+			for (int k=0; k<(int)miss.size(); k++)
+				solver[miss[k]]->Prepare(flow, &result[miss[k]], &batch, k);
+			avd_flux(&batch);
+			for (int k=0; k<(int)miss.size(); k++) {
+				result[miss[k]].avd = avd_get(batch, k);
+				solver[miss[k]]->Remember(result[miss[k]]);
+			}
+		}
+		pool->run(&task, groups());
+		TIMESTEP = solver[0]->timestep();
+		for (int s=1; s<count(); s++) {
+			/* All stations start each step with the same step and must end it together. */
+			assert(solver[s]->model()->CURRENT_TIME == thm->CURRENT_TIME);
+			TIMESTEP = min(TIMESTEP, solver[s]->timestep());
+		}
+	}
+	for (int s=0; s<count(); s++)
+		result[s].time = thm->CURRENT_TIME;
+}
+
+void CSurfaceMap::printHeader(FILE* out)
+{
+	fprintf(out, "%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\n", "TIME", "X", "PHI", "QCONV", "DY", "TW", "G");
+}
+
+void CSurfaceMap::print(FILE* out)
+{
+	/* Blocks of equal time are separated by an empty line. */
+	for (int s=0; s<count(); s++) {
+		thm_t* thm = solver[s]->model();
+		fprintf(out, "%7.2lf\t%7.4lf\t%7.2lf\t%7.1lf\t%7.3lf\t%7.1lf\t%7.4lf\n", result[s].time, X[s], PHI[s],
+			result[s].avd.QCONV/4186.8, thm->LDEL*1000., thm->TWL, result[s].G);
+	}
+	fprintf(out, "\n");
+}
@@ -1,37 +1,82 @@
 #include <cmath>
+#include <cstring>
 #include <common.h>
 #include <tdma.h>
 
-/* ----- DATA ----- */
-
-static double* T;
-static double* l;
-static double* r;
-static double* c;
-static double* w;
-static double* qv;
-static double A[CELLS_MAX_NUM];
-static double B[CELLS_MAX_NUM];
-static double C[CELLS_MAX_NUM];
-static double F[CELLS_MAX_NUM];
-static double alpha[CELLS_MAX_NUM];
-static double betta[CELLS_MAX_NUM];
-static int FIRST;
-static int LAST;
-
 /* ----- FUNCTIONS ----- */
 
+CTDMASolver::CTDMASolver()
+{
+	CAPACITY = 0;
+	isOwner = false;
+	A = B = C = F = alpha = betta = 0;
+}
+
+CTDMASolver::CTDMASolver(int capacity)
+{
+	assert(capacity > 1);
+	CAPACITY = capacity;
+	isOwner = true;
+	attach(new double[workspaceSize(capacity)]);
+}
+
+CTDMASolver::CTDMASolver(double* workspace, int capacity)
+{
+	assert(capacity > 1);
+	assert(workspace != 0);
+	CAPACITY = capacity;
+	isOwner = false;
+	attach(workspace);
+}
+
+CTDMASolver::~CTDMASolver()
+{
+	if (isOwner)
+		delete [] A;
+}
+
+int CTDMASolver::workspaceSize(int capacity)
+{
+	return 6*capacity;
+}
+
+int CTDMASolver::capacity() const
+{
+	return CAPACITY;
+}
+
+void CTDMASolver::setWorkspace(double* workspace, int capacity)
+{
+	assert(capacity > 1);
+	assert(workspace != 0);
+	if (isOwner)
+		delete [] A;
+	CAPACITY = capacity;
+	isOwner = false;
+	attach(workspace);
+}
+
+void CTDMASolver::attach(double* workspace)
+{
+	A = workspace;
+	B = A + CAPACITY;
+	C = B + CAPACITY;
+	F = C + CAPACITY;
+	alpha = F + CAPACITY;
+	betta = alpha + CAPACITY;
+}
+
 /**
  * @brief Метод прогонки.
- * @param T1 - указатель на массив температур, в который будет занесен результат расчета.
- * Размерность T1 должна быть не менее last
+ * @param T - указатель на массив температур, в который будет занесен результат расчета.
+ * Размерность T должна быть не менее LAST+1
  */
-static void TDMA()
+void CTDMASolver::TDMA(double* T, int LAST)
 {
 	double hi2 = A[LAST]/C[LAST];
 	double mu2 = F[LAST]/C[LAST];
-	alpha[FIRST] = 0.;
-	betta[FIRST] = 0.;
+	alpha[0] = 0.;
+	betta[0] = 0.;
 	/* Прямой ход прогонки. */
 	for (int i=0; i<LAST; i++) {
 		alpha[i+1] = B[i]/(C[i]-alpha[i]*A[i]);
@@ -43,66 +88,261 @@ static void TDMA()
 		T[i] = alpha[i+1]*T[i+1]+betta[i+1];
 }
 
-static double Twl()
-{
-	return T[FIRST];
-}
-static double Twr()
+/**
+ * @brief Сформировать коэффициенты трёхдиагональной системы.
+ * @details Коэффициенты ячейки i заносятся по индексу i*stride, что позволяет
+ * заполнять как обычные массивы (stride = 1), так и дорожки пакета.
+ * Излучение с границ линеаризуется около температур Tl (при Tl = 0 - около T).
+ * Скорости сетки u (при u != 0) дают противопоточный конвективный член u*dT/dx.
+ */
+static void AssembleTDMA(	double* T, double* w, double* qv, double* l, double* r, double* c,
+			double Eps[2], double thau, int size,
+			double* A, double* B, double* C, double* F, int stride, double theta,
+			const double* Tl, const double* u)
 {
-	return T[LAST];
-}
+	const int FIRST = 0;
+	const int LAST = size-1;
 
-void CalculateTDMA(	double* Temp, double* Width, double* VolHeatSrc,
-			double* HeatCond, double* Density, double* SpecHeat,
-			double Eps[2], double thau, int size)
-{
-	T = Temp;
-	w = Width;
-	qv = VolHeatSrc;
-	l = HeatCond;
-	r = Density;
-	c = SpecHeat;
-	FIRST = 0;
-	LAST = size-1;
-	
 	assert((Eps[0] >= 0.) && (Eps[0] <= 1.));
 	assert((Eps[1] >= 0.) && (Eps[1] <= 1.));
-	assert(thau > 0.); assert(size < CELLS_MAX_NUM);
+	assert(thau > 0.);
+	assert((theta >= 0.) && (theta <= 1.));
 	assert(T != 0); assert(w != 0);
 	assert(qv != 0); assert(l != 0);
 	assert(r != 0); assert(c != 0);
 
 	for (int i=FIRST; i<=LAST; i++) {
+		const int k = i*stride;
 		double CpRho = c[i]*r[i];
 		if (i == FIRST) {
-			A[FIRST] = 0.;
-			qv[FIRST] += 3.*(Eps[0]*5.67/w[FIRST])*pow(T[FIRST]/100., 4.); // С нормализацией
+			A[k] = 0.;
+			if (Tl == 0)
+				qv[FIRST] += (4.*theta-1.)*(Eps[0]*5.67/w[FIRST])*pow(T[FIRST]/100., 4.); // С нормализацией
+			else
+				/* Явная часть излучения - по T, неявная линеаризуется около Tl. */
+				qv[FIRST] += (Eps[0]*5.67/w[FIRST])*(3.*theta*pow(Tl[FIRST]/100., 4.) - (1.-theta)*pow(T[FIRST]/100., 4.));
 //			qv[FIRST] -= (Eps[0]*5.67/w[FIRST])*pow(T[FIRST]/100., 4.);
 		} else {
 			double ll = (w[i-1]+w[i])/(w[i-1]/l[i-1]+w[i]/l[i]);
-			A[i] = 2.*thau*(ll/CpRho)/(w[i]*(w[i-1]+w[i]));
+			A[k] = 2.*thau*(ll/CpRho)/(w[i]*(w[i-1]+w[i]));
 		}
 		if (i == LAST)
-			B[i] = 0.;
+			B[k] = 0.;
 		else {
 			double lr = (w[i+1]+w[i])/(w[i+1]/l[i+1]+w[i]/l[i]);
-			B[i] = 2.*thau*(lr/CpRho)/(w[i]*(w[i+1]+w[i]));
+			B[k] = 2.*thau*(lr/CpRho)/(w[i]*(w[i+1]+w[i]));
+		}
+		F[k] = T[i] + thau*qv[i]/CpRho;
+		if (theta != 1.) {
+			/* Явная часть оператора теплопроводности (схема с весами). */
+			if (i != FIRST)
+				F[k] += (1.-theta)*A[k]*(T[i-1]-T[i]);
+			if (i != LAST)
+				F[k] += (1.-theta)*B[k]*(T[i+1]-T[i]);
+			A[k] *= theta;
+			B[k] *= theta;
+		}
+		C[k] = 1.+A[k]+B[k];
+		if ((u != 0) && (u[i] != 0.) && (i != LAST)) {
+			/* Подвижная сетка: материал набегает на ячейку справа. */
+			double adv = 2.*thau*u[i]/(w[i]+w[i+1]);
+			F[k] += (1.-theta)*adv*(T[i+1]-T[i]);
+			B[k] += theta*adv;
+			C[k] += theta*adv;
 		}
-		C[i] = 1.+A[i]+B[i];
 		if (i == FIRST)
-			C[i] += 4.*Eps[0]*5.67E-02*(thau/CpRho)*pow(T[FIRST]/100., 3.)/w[FIRST]; // С нормализацией
-		F[i] = T[i] + thau*qv[i]/CpRho;
+			C[k] += 4.*theta*Eps[0]*5.67E-02*(thau/CpRho)*pow(((Tl == 0) ? T[FIRST] : Tl[FIRST])/100., 3.)/w[FIRST]; // С нормализацией
 		if (i == LAST-1) {
 			double eps = Eps[1];
-			double A4 = 4*eps*5.67E-08*(thau/CpRho)*w[LAST]*pow(Twr(), 3.)/(w[LAST-1]*l[LAST]*(w[LAST-1]/l[LAST-1]+w[LAST]/l[LAST]));
-			double A5 = -4*eps*5.67E-08*(thau/CpRho)*pow(Twr(), 3.)/(l[LAST-1]*(w[LAST-1]/l[LAST-1]+w[LAST]/l[LAST]));
-			double A6 = -4*eps*5.67E-08*(thau/CpRho)*(pow(Twr(), 4.)/(4.*w[LAST-1])-pow(Twr(), 4.)/w[LAST-1]);
-			A[i] += 0.;
-			C[i] += A4;
-			B[i] += A5;
-			F[i] += A6;
+			double Twr = (Tl == 0) ? T[LAST] : Tl[LAST];
+			double A4 = 4*eps*5.67E-08*(thau/CpRho)*w[LAST]*pow(Twr, 3.)/(w[LAST-1]*l[LAST]*(w[LAST-1]/l[LAST-1]+w[LAST]/l[LAST]));
+			double A5 = -4*eps*5.67E-08*(thau/CpRho)*pow(Twr, 3.)/(l[LAST-1]*(w[LAST-1]/l[LAST-1]+w[LAST]/l[LAST]));
+			double A6 = -4*eps*5.67E-08*(thau/CpRho)*(pow(Twr, 4.)/(4.*w[LAST-1])-pow(Twr, 4.)/w[LAST-1]);
+			/* Явная часть излучения - по температуре стенки между ячейками LAST-1 и LAST. */
+			double Tw = (T[LAST-1]*w[LAST]/l[LAST]+T[LAST]*w[LAST-1]/l[LAST-1])/(w[LAST-1]/l[LAST-1]+w[LAST]/l[LAST]);
+			A[k] += 0.;
+			C[k] += theta*A4;
+			B[k] += theta*A5;
+			F[k] += theta*A6 - (1.-theta)*eps*5.67E-08*(thau/CpRho)*pow(Tw, 4.)/w[LAST-1];
 		}
 	}
+}
+
+void CTDMASolver::Calculate(	double* T, double* w, double* qv,
+				double* l, double* r, double* c,
+				double Eps[2], double thau, int size, double theta, const double* Tl,
+				const double* u)
+{
+	assert(size <= CAPACITY);
+	AssembleTDMA(T, w, qv, l, r, c, Eps, thau, size, A, B, C, F, 1, theta, Tl, u);
 	/* Итеративное выполнение прогонки до тех пор, пока не устоится температура внешней стенки. */
-	TDMA();
+	TDMA(T, size-1);
+}
+
+void CTDMASolver::Solve(	const double* A, const double* B, const double* C, const double* F,
+				double* X, int size)
+{
+	assert((size > 1) && (size <= CAPACITY));
+	memcpy(this->A, A, size*sizeof(double));
+	memcpy(this->B, B, size*sizeof(double));
+	memcpy(this->C, C, size*sizeof(double));
+	memcpy(this->F, F, size*sizeof(double));
+	this->A[0] = 0.;
+	this->B[size-1] = 0.;
+	TDMA(X, size-1);
+}
+
+/* ----- BATCH ----- */
+
+CTDMABatch::CTDMABatch(int capacity)
+{
+	assert(capacity > 1);
+	CAPACITY = capacity;
+	isOwner = true;
+	double* workspace = (double*)aligned_alloc(64, workspaceSize(capacity)*sizeof(double));
+	assert(workspace != 0);
+	attach(workspace);
+}
+
+CTDMABatch::CTDMABatch(double* workspace, int capacity)
+{
+	assert(capacity > 1);
+	assert(workspace != 0);
+	assert(((size_t)workspace % 64) == 0);
+	CAPACITY = capacity;
+	isOwner = false;
+	attach(workspace);
+}
+
+CTDMABatch::~CTDMABatch()
+{
+	if (isOwner)
+		free(A);
+}
+
+int CTDMABatch::workspaceSize(int capacity)
+{
+	/* Размер каждого массива кратен 64 байтам, чтобы все массивы были выровнены. */
+	return 7*capacity*TDMA_LANES + (8-(7*capacity*TDMA_LANES)%8)%8;
+}
+
+int CTDMABatch::capacity() const
+{
+	return CAPACITY;
+}
+
+void CTDMABatch::attach(double* workspace)
+{
+	const int n = CAPACITY*TDMA_LANES;
+	A = workspace;
+	B = A + n;
+	C = B + n;
+	F = C + n;
+	alpha = F + n;
+	betta = alpha + n;
+	X = betta + n;
+	assembled = 0;
+}
+
+void CTDMABatch::Assemble(	int lane, double* T, double* w, double* qv,
+				double* l, double* r, double* c,
+				double Eps[2], double thau, int size, double theta, const double* Tl)
+{
+	assert((lane >= 0) && (lane < TDMA_LANES));
+	assert(size <= CAPACITY);
+	AssembleTDMA(T, w, qv, l, r, c, Eps, thau, size, &A[lane], &B[lane], &C[lane], &F[lane], TDMA_LANES, theta, Tl, 0);
+	assembled |= (1 << lane);
+}
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX512F__)
+typedef __m512d vec_t;
+#define VLOAD(p)		_mm512_load_pd(p)
+#define VSTORE(p, v)		_mm512_store_pd(p, v)
+#define VSET1(x)		_mm512_set1_pd(x)
+#define VADD(a, b)		_mm512_add_pd(a, b)
+#define VSUB(a, b)		_mm512_sub_pd(a, b)
+#define VMUL(a, b)		_mm512_mul_pd(a, b)
+#define VDIV(a, b)		_mm512_div_pd(a, b)
+#elif defined(__AVX2__)
+typedef __m256d vec_t;
+#define VLOAD(p)		_mm256_load_pd(p)
+#define VSTORE(p, v)		_mm256_store_pd(p, v)
+#define VSET1(x)		_mm256_set1_pd(x)
+#define VADD(a, b)		_mm256_add_pd(a, b)
+#define VSUB(a, b)		_mm256_sub_pd(a, b)
+#define VMUL(a, b)		_mm256_mul_pd(a, b)
+#define VDIV(a, b)		_mm256_div_pd(a, b)
+#endif
+
+void CTDMABatch::Solve(int size)
+{
+	const int L = TDMA_LANES;
+	const int LAST = size-1;
+	assert((size > 1) && (size <= CAPACITY));
+	/* Незаполненные дорожки: единичная система, чтобы не получить деления на ноль. */
+	for (int k=0; k<L; k++) {
+		if (assembled & (1 << k))
+			continue;
+		for (int i=0; i<size; i++) {
+			A[i*L+k] = 0.;
+			B[i*L+k] = 0.;
+			C[i*L+k] = 1.;
+			F[i*L+k] = 0.;
+		}
+	}
+	assembled = 0;
+#if defined(__AVX512F__) || defined(__AVX2__)
+	VSTORE(&alpha[0], VSET1(0.));
+	VSTORE(&betta[0], VSET1(0.));
+	/* Прямой ход прогонки. */
+	for (int i=0; i<LAST; i++) {
+		vec_t a = VLOAD(&A[i*L]);
+		vec_t al = VLOAD(&alpha[i*L]);
+		vec_t den = VSUB(VLOAD(&C[i*L]), VMUL(al, a));
+		VSTORE(&alpha[(i+1)*L], VDIV(VLOAD(&B[i*L]), den));
+		VSTORE(&betta[(i+1)*L], VDIV(VADD(VMUL(a, VLOAD(&betta[i*L])), VLOAD(&F[i*L])), den));
+	}
+	/* Обратный ход прогонки. */
+	vec_t hi2 = VDIV(VLOAD(&A[LAST*L]), VLOAD(&C[LAST*L]));
+	vec_t mu2 = VDIV(VLOAD(&F[LAST*L]), VLOAD(&C[LAST*L]));
+	vec_t x = VDIV(VADD(mu2, VMUL(hi2, VLOAD(&betta[LAST*L]))), VSUB(VSET1(1.), VMUL(VLOAD(&alpha[LAST*L]), hi2)));
+	VSTORE(&X[LAST*L], x);
+	for (int i=LAST-1; i>=0; i--) {
+		x = VADD(VMUL(VLOAD(&alpha[(i+1)*L]), x), VLOAD(&betta[(i+1)*L]));
+		VSTORE(&X[i*L], x);
+	}
+#else
+	for (int k=0; k<L; k++) {
+		alpha[k] = 0.;
+		betta[k] = 0.;
+	}
+	/* Прямой ход прогонки. */
+	for (int i=0; i<LAST; i++)
+		for (int k=0; k<L; k++) {
+			double den = C[i*L+k]-alpha[i*L+k]*A[i*L+k];
+			alpha[(i+1)*L+k] = B[i*L+k]/den;
+			betta[(i+1)*L+k] = (A[i*L+k]*betta[i*L+k]+F[i*L+k])/den;
+		}
+	/* Обратный ход прогонки. */
+	for (int k=0; k<L; k++) {
+		double hi2 = A[LAST*L+k]/C[LAST*L+k];
+		double mu2 = F[LAST*L+k]/C[LAST*L+k];
+		X[LAST*L+k] = (mu2+hi2*betta[LAST*L+k])/(1-alpha[LAST*L+k]*hi2);
+	}
+	for (int i=LAST-1; i>=0; i--)
+		for (int k=0; k<L; k++)
+			X[i*L+k] = alpha[(i+1)*L+k]*X[(i+1)*L+k]+betta[(i+1)*L+k];
+#endif
+}
+
+void CTDMABatch::Result(int lane, double* T, int size) const
+{
+	assert((lane >= 0) && (lane < TDMA_LANES));
+	assert(size <= CAPACITY);
+	for (int i=0; i<size; i++)
+		T[i] = X[i*TDMA_LANES+lane];
 }
@@ -0,0 +1,78 @@
+#include <threadpool.h>
+
+CThreadPool::CThreadPool(int threads)
+{
+	if (threads <= 0)
+		threads = max((int)thread::hardware_concurrency(), 1);
+	THREADS = threads;
+	task = 0;
+	COUNT = 0;
+	next = 0;
+	active = 0;
+	generation = 0;
+	stop = false;
+	for (int i=1; i<THREADS; i++)
+		workers.push_back(thread(&CThreadPool::worker, this, i));
+}
+
+CThreadPool::~CThreadPool()
+{
+	{
+		unique_lock<mutex> lk(lock);
+		stop = true;
+	}
+	start.notify_all();
+	for (size_t i=0; i<workers.size(); i++)
+		workers[i].join();
+}
+
+int CThreadPool::size() const
+{
+	return THREADS;
+}
+
+void CThreadPool::process(int id)
+{
+	for (int i = next++; i < COUNT; i = next++)
+		task->run(i, id);
+}
+
+void CThreadPool::worker(int id)
+{
+	unsigned seen = 0;
+	for (;;) {
+		{
+			unique_lock<mutex> lk(lock);
+			while (!stop && (generation == seen))
+				start.wait(lk);
+			if (stop)
+				return;
+			seen = generation;
+		}
+		process(id);
+		unique_lock<mutex> lk(lock);
+		if (--active == 0)
+			done.notify_one();
+	}
+}
+
+void CThreadPool::run(CTask* task, int count)
+{
+	assert(task != 0);
+	if (count <= 0)
+		return;
+	{
+		unique_lock<mutex> lk(lock);
+		this->task = task;
+		COUNT = count;
+		next = 0;
+		active = THREADS-1;
+		generation++;
+	}
+	start.notify_all();
+	process(0);
+	unique_lock<mutex> lk(lock);
+	while (active > 0)
+		done.wait(lk);
+	this->task = 0;
+}
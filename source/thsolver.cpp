@@ -1,100 +1,238 @@
-#include <tdma.h>
 #include <thsolver.h>
 #include <boundary.h>
+#include <checkpoint.h>
 #include <cstring>
 
 #define NEED_SMALLER_STEP	(1)
 #define TIMESTEP_MIN_CALCS	(2)
 
+/* PI step-size controller of the TR-BDF2 scheme. */
+#define PI_SAFETY		(0.9)
+#define PI_FACMIN		(0.2)
+#define PI_FACMAX		(5.0)
+#define PI_BETA1		(0.7/2.)
+#define PI_BETA2		(0.4/2.)
+
+/* Share of the surface layer the moving grid may remove in one step, the rest is cropped. */
+#define RECEDE_MAX		(0.5)
+
 CTHSolver::CTHSolver(thm_t* thm)
 {
 	assert(thm != 0);
 	this->thm = thm;
 	this->TIMESTEP_MIN = STD_TIMESTEP_MIN;
 	this->TIMESTEP_MAX = STD_TIMESTEP_MAX;
+	this->DT_MAX = 0.;
+	this->SCHEME = SCHEME_EULER;
+	this->TOL = 1.;
+	this->ERR = 0.;
+	this->ERR_PREV = 1.;
+	this->NEXT_TIMESTEP = STD_TIMESTEP_MAX;
+	this->PICARD_ITERS_MAX = 0;
+	this->PICARD_TOL = 1.0E-3;
+	this->recession = 0;
+	this->VREC = 0.;
+	this->RL = 0;
+	this->CAPACITY = 0;
+	allocate(thm->capacity()+2);
 	this->T[0] = thm->T[thm->fcnum];
-	for (int i=1; i< CELLS_MAX_NUM; i++) {
+}
+
+void CTHSolver::allocate(int cells)
+{
+	if (cells <= CAPACITY)
+		return;
+	int ws = CTDMASolver::workspaceSize(cells);
+	arena.reserve(11*CArena::align(cells*sizeof(double))+CArena::align(ws*sizeof(double)));
+	T = arena.alloc<double>(cells);
+	w = arena.alloc<double>(cells);
+	l = arena.alloc<double>(cells);
+	c = arena.alloc<double>(cells);
+	r = arena.alloc<double>(cells);
+	qv = arena.alloc<double>(cells);
+	Tn = arena.alloc<double>(cells);
+	Est = arena.alloc<double>(cells);
+	Told = arena.alloc<double>(cells);
+	Tk = arena.alloc<double>(cells);
+	u = arena.alloc<double>(cells);
+	tdma.setWorkspace(arena.alloc<double>(ws), cells);
+	CAPACITY = cells;
+	for (int i=0; i<cells; i++) {
 		T[i] = -1.;
 		l[i] = -1.;
 		c[i] = -1.;
 		r[i] = -1.;
 		qv[i] = 0.;
+		u[i] = 0.;
 	}
 }
 
+void CTHSolver::reserve()
+{
+	allocate(thm->capacity()+2);
+}
+
 CTHSolver::~CTHSolver()
 {
 }
 	
 solve_result_t CTHSolver::Solve(double time)
 {
-	sres.QLconv = 0.;
-	sres.QLrad = 0.;
-	sres.QRconv = 0.;
-	sres.QRrad = 0.;
-	sres.dHeatQty = 0.;
-	double dHeatQty = 0.;
-	double residual = 0.;
-	int counter = 0;
 	double dt = time - thm->CURRENT_TIME;
-	Prepare();
+	Begin();
 	double TIMESTEP = time - thm->CURRENT_TIME;
-	bool isPrintWTmin = false;
+	if (SCHEME != SCHEME_EULER)
+		TIMESTEP = min(NEXT_TIMESTEP, TIMESTEP);
 	assert(time - thm->CURRENT_TIME > 0.);
 	while (thm->CURRENT_TIME < time) {
 		double HeatQty_Pre = Pre(thm->CURRENT_TIME);
 		double twlk = Twl();
 		double twrk = Twr();
 		int res = DoIteration(TIMESTEP);
+		if ((SCHEME != SCHEME_EULER) && (ERR > 1.) && (TIMESTEP > TIMESTEP_MIN)) {
+			/* Local error is too large: repeat the step with a smaller one. */
+			Prepare();
+			REJECTED++;
+			TIMESTEP = max(TIMESTEP*max(PI_FACMIN, PI_SAFETY*pow(ERR, -0.5)), TIMESTEP_MIN);
+			continue;
+		}
 		if (res == NEED_SMALLER_STEP) {
 			Prepare();
 			if (TIMESTEP > TIMESTEP_MIN)
 				TIMESTEP = TIMESTEP/2.;
 			continue;
-		} else if ((res == SUCCESS) || (res == TIMESTEP_MIN_CALCS)) {
-			thm->CURRENT_TIME += TIMESTEP;
-			counter++;
-			dHeatQty = Post(thm->CURRENT_TIME)-HeatQty_Pre;
-			/* Calculate heat quantity at boundaries */
-			double ql;
-			if (thm->LBC->type() != 1) { // Second-order left BC
-				BC_t bc = thm->LBC->GetBC(thm->CURRENT_TIME-TIMESTEP);
-				double qlconv, qlrad;
-				qlconv = bc.acp*(bc.Ie-bc.Iw);
-				sres.QLconv+= qlconv*TIMESTEP;
-				qlrad = (-bc.eps*5.67E-08*(pow(twlk, 4.)+4*pow(twlk, 3.)*(Twl()-twlk)));
-				sres.QLrad += qlrad*TIMESTEP;
-				ql = qlconv+qlrad;
-			} else
-				ql = 2*(twlk-T[1])*l[1]/w[1];
-			double qr;
-			if (thm->RBC->type() != 1) { // Second-order left BC
-				BC_t bc = thm->RBC->GetBC(thm->CURRENT_TIME-TIMESTEP);
-				double qrconv, qrrad;
-				qrconv = bc.acp*(bc.Ie-bc.Iw);
-				sres.QRconv+= qrconv*TIMESTEP;
-				qrrad = (-bc.eps*5.67E-08*(pow(twrk, 4.)+4*TIMESTEP*pow(twrk, 3.)*(Twr()-twrk)/TIMESTEP));
-				sres.QRrad += qrrad*TIMESTEP;
-				qr = qrconv+qrrad;
-			} else
-				qr = 2*(twrk-T[SIZE-2])*l[SIZE-2]/w[SIZE-2];
-			sres.dHeatQty += (ql+qr)*TIMESTEP-dHeatQty;
-		} else
+		} else if ((res == SUCCESS) || (res == TIMESTEP_MIN_CALCS))
+			Accept(TIMESTEP, HeatQty_Pre, twlk, twrk);
+		else
 			assert(0 || !printf("[EE]: Unknown result value: %d\n", res));
-		TIMESTEP = min(TIMESTEP*1.1, TIMESTEP_MAX);
+		if (SCHEME != SCHEME_EULER) {
+			/* A step cut by the stop point doesn't limit the next call. */
+			bool isCut = (TIMESTEP < NEXT_TIMESTEP);
+			double next = Controller(TIMESTEP);
+			NEXT_TIMESTEP = isCut ? max(next, NEXT_TIMESTEP) : next;
+			TIMESTEP = min(NEXT_TIMESTEP, TIMESTEP_MAX);
+		} else
+			TIMESTEP = min(TIMESTEP*1.1, TIMESTEP_MAX);
 		TIMESTEP = min(TIMESTEP, time-thm->CURRENT_TIME);
 	}
+	Finish(dt);
+	return sres;
+}
+
+double CTHSolver::Controller(double TIMESTEP)
+{
+	double err = max(ERR, 1.0E-10);
+	double fac = PI_SAFETY*pow(err, -PI_BETA1)*pow(ERR_PREV, PI_BETA2);
+	ERR_PREV = max(ERR, 1.0E-4);
+	fac = min(PI_FACMAX, max(PI_FACMIN, fac));
+	return max(TIMESTEP*fac, TIMESTEP_MIN);
+}
+
+void CTHSolver::Begin()
+{
+	sres.QLconv = 0.;
+	sres.QLrad = 0.;
+	sres.QRconv = 0.;
+	sres.QRrad = 0.;
+	sres.dHeatQty = 0.;
+	STEPS = 0;
+	REJECTED = 0;
+	PICARD_ITERS = 0;
+	PICARD_MAX = 0;
+	PICARD_FAILS = 0;
+	RECESSION = 0.;
+	Prepare();
+}
+
+void CTHSolver::Accept(double TIMESTEP, double HeatQty_Pre, double twlk, double twrk)
+{
+	thm->CURRENT_TIME += TIMESTEP;
+	STEPS++;
+	double dHeatQty = Post(thm->CURRENT_TIME)-HeatQty_Pre;
+	/* Calculate heat quantity at boundaries */
+	double ql;
+	if (thm->LBC->type() != 1) { // Second-order left BC
+		BC_t bc = thm->LBC->GetBC(thm->CURRENT_TIME-TIMESTEP);
+		double qlconv, qlrad;
+		qlconv = bc.acp*(bc.Ie-bc.Iw);
+		sres.QLconv+= qlconv*TIMESTEP;
+		qlrad = (-bc.eps*5.67E-08*(pow(twlk, 4.)+4*pow(twlk, 3.)*(Twl()-twlk)));
+		sres.QLrad += qlrad*TIMESTEP;
+		ql = qlconv+qlrad;
+	} else
+		ql = 2*(twlk-T[1])*l[1]/w[1];
+	double qr;
+	if (thm->RBC->type() != 1) { // Second-order left BC
+		BC_t bc = thm->RBC->GetBC(thm->CURRENT_TIME-TIMESTEP);
+		double qrconv, qrrad;
+		qrconv = bc.acp*(bc.Ie-bc.Iw);
+		sres.QRconv+= qrconv*TIMESTEP;
+		qrrad = (-bc.eps*5.67E-08*(pow(twrk, 4.)+4*TIMESTEP*pow(twrk, 3.)*(Twr()-twrk)/TIMESTEP));
+		sres.QRrad += qrrad*TIMESTEP;
+		qr = qrconv+qrrad;
+	} else
+		qr = 2*(twrk-T[SIZE-2])*l[SIZE-2]/w[SIZE-2];
+	sres.dHeatQty += (ql+qr)*TIMESTEP-dHeatQty;
+	if ((recession != 0) && (VREC > 0.)) {
+		double dx = VREC*TIMESTEP;
+		if (dx < RECEDE_MAX*thm->thickness(RL)) {
+			/* Move the left boundary: the surface layer shrinks uniformly. */
+			double k = thm->recede(dx, RL);
+			for (int j=1; j<=RL; j++)
+				w[j] *= k;
+		} else {
+			/* The surface layer is almost consumed: cut it off as the fixed grid does. */
+			thm->crop(0, dx);
+			Prepare();
+		}
+		RECESSION += dx;
+	}
+}
+
+void CTHSolver::Finish(double dt)
+{
 	sres.dHeatQty/=(sres.QLconv+sres.QLrad);
-	sres.LAST_TIMESTEP = max(dt/counter, STD_TIMESTEP_MIN);
-	TIMESTEP_MIN = sres.LAST_TIMESTEP;
+	sres.LAST_TIMESTEP = max(dt/STEPS, STD_TIMESTEP_MIN);
+	sres.NEXT_TIMESTEP = NEXT_TIMESTEP;
+	sres.STEPS = STEPS;
+	sres.REJECTED = REJECTED;
+	sres.PICARD_ITERS = PICARD_ITERS;
+	sres.PICARD_MAX = PICARD_MAX;
+	sres.PICARD_FAILS = PICARD_FAILS;
+	sres.RECESSION = RECESSION;
+	if (SCHEME == SCHEME_EULER)
+		TIMESTEP_MIN = sres.LAST_TIMESTEP;
+}
+
+const solve_result_t& CTHSolver::result() const
+{
 	return sres;
 }
 
+void CTHSolver::save(FILE* f) const
+{
+	/* Work arrays are refilled from the model at the start of each Solve(). */
+	ckpt_write(f, &TIMESTEP_MIN);
+	ckpt_write(f, &NEXT_TIMESTEP);
+	ckpt_write(f, &ERR);
+	ckpt_write(f, &ERR_PREV);
+	ckpt_write(f, &VREC);
+}
+
+int CTHSolver::load(FILE* f)
+{
+	if (!ckpt_read(f, &TIMESTEP_MIN) || !ckpt_read(f, &NEXT_TIMESTEP) ||
+		!ckpt_read(f, &ERR) || !ckpt_read(f, &ERR_PREV) || !ckpt_read(f, &VREC))
+		return NULL_VALUE;
+	return SUCCESS;
+}
+
 void CTHSolver::Prepare()
 {
-	assert(thm->lcnum < CELLS_MAX_NUM+2);
 	assert(thm->fcnum >= 0);
 	SIZE = thm->lcnum-thm->fcnum+3;
+	/* The storage follows the capacity of the model, so it grows once per model growth. */
+	allocate(max(SIZE, thm->capacity()+2));
 	w[0]= thm->PrimaryLeftCellSize/100.;
 	w[SIZE-1]= thm->PrimaryRightCellSize/100.;
 	T[0]= thm->TWL;
@@ -102,17 +240,14 @@ void CTHSolver::Prepare()
 	/* Make a internal copy of thermal model */
 	memcpy(&(T[1]), &(thm->T[thm->fcnum]), (SIZE-2)*sizeof(double));
 	memcpy(&(w[1]), &(thm->width[thm->fcnum]), (SIZE-2)*sizeof(double));
+	/* Surface layer moving with the left boundary. */
+	for (RL=0; (thm->fcnum+RL <= thm->lcnum) && (thm->mid[thm->fcnum+RL] == thm->mid[thm->fcnum]); RL++);
 }
 double CTHSolver::Pre(double time)
 {
 //	printf("PRE:\n");
 	/* Update thermal properties */
-	for (int j=1; j<SIZE-1; j++) {
-		int i = j+thm->fcnum-1;
-		l[j] = thm->m[i]->l(T[j]);
-		c[j] = thm->m[i]->c(T[j]);
-		r[j] = thm->m[i]->r(T[j]);
-	}
+	Properties(T);
 	/* Update boundaries */
 	setBoundaries(thm->LBC, thm->RBC, time);
 	/** Calculate heat quantity */
@@ -131,10 +266,132 @@ double CTHSolver::Post(double time)
 	thm->TWR = Twr();
 	return currentHeatQty();
 }
+void CTHSolver::Properties(const double* T)
+{
+	/* One batch call per layer: cell i of the model is element j = i-fcnum+1. */
+	for (size_t k=0; k<thm->layers.size(); k++) {
+		const layer_t& layer = thm->layers[k];
+		int first = max(layer.first, thm->fcnum);
+		if (first > layer.last)
+			continue;
+		int j = first-thm->fcnum+1;
+		layer.M->props(&(T[j]), &(l[j]), &(c[j]), &(r[j]), layer.last-first+1);
+	}
+	/* Boundary cells take properties of the adjacent cells, as setBoundaries() does. */
+	double k = (thm->LBC->type() == 1) ? 1.0E+03 : 1.;
+	l[0] = ((thm->LBC->type() == 1) ? 1.0E+15 : 1.)*l[1];
+	c[0] = k*c[1];
+	r[0] = k*r[1];
+	k = (thm->RBC->type() == 1) ? 1.0E+03 : 1.;
+	l[SIZE-1] = ((thm->RBC->type() == 1) ? 1.0E+15 : 1.)*l[SIZE-2];
+	c[SIZE-1] = k*c[SIZE-2];
+	r[SIZE-1] = k*r[SIZE-2];
+}
+void CTHSolver::GridVelocity(double V)
+{
+	double L = 0.;
+	for (int j=1; j<=RL; j++)
+		L += w[j];
+	/* Grid points move with the velocity V at the surface and stay at the back face of the layer. */
+	double x = 0.;
+	for (int j=1; j<=RL; j++) {
+		x += w[j]/2.;
+		u[j] = V*(1.-x/L);
+		x += w[j]/2.;
+	}
+	for (int j=RL+1; j<SIZE; j++)
+		u[j] = 0.;
+}
+int CTHSolver::Implicit(double* T, double thau, double theta)
+{
+	if ((PICARD_ITERS_MAX == 0) && (recession == 0)) {
+		tdma.Calculate(T, w, qv, l, r, c, eps, thau, SIZE, theta);
+		return SUCCESS;
+	}
+	const double qvl = qv[0];
+	const double qvr = qv[SIZE-1];
+	/* The moving grid always iterates the recession velocity. */
+	const int ITERS_MAX = (PICARD_ITERS_MAX > 0) ? PICARD_ITERS_MAX : PICARD_ITERS_STD;
+	memcpy(Told, T, SIZE*sizeof(double));
+	memcpy(Tk, T, SIZE*sizeof(double));
+	for (int k=1; k<=ITERS_MAX; k++) {
+		if (k > 1) {
+			/* Properties at the implicit level, radiation is linearized about the iterate. */
+			Properties(Tk);
+			qv[0] = qvl;
+			qv[SIZE-1] = qvr;
+			memcpy(T, Told, SIZE*sizeof(double));
+		}
+		if (recession != 0) {
+			VREC = max(recession->velocity(Tk[0]), 0.);
+			GridVelocity(VREC);
+		}
+		tdma.Calculate(T, w, qv, l, r, c, eps, thau, SIZE, theta, Tk, (recession != 0) ? u : 0);
+		double delta = 0.;
+		for (int i=0; i<SIZE-1; i++)
+			delta = max(delta, fabs(T[i]-Tk[i]));
+		memcpy(Tk, T, SIZE*sizeof(double));
+		PICARD_ITERS++;
+		PICARD_MAX = max(PICARD_MAX, k);
+		if (delta < PICARD_TOL)
+			return SUCCESS;
+	}
+	PICARD_FAILS++;
+	return NEED_SMALLER_STEP;
+}
 int CTHSolver::DoIteration(double TIMESTEP)
 {
-	double tempT0 = T[0];
-	CalculateTDMA(T, w, qv, l, r, c, eps, TIMESTEP, SIZE);
+	TWL_PREV = T[0];
+	if (SCHEME == SCHEME_TRBDF2)
+		return DoIterationTRBDF2(TIMESTEP);
+	if ((Implicit(T, TIMESTEP) != SUCCESS) && (TIMESTEP > TIMESTEP_MIN))
+		return NEED_SMALLER_STEP;
+	return Check(TIMESTEP);
+}
+int CTHSolver::DoIterationTRBDF2(double TIMESTEP)
+{
+	const double g = 2.-sqrt(2.);
+	/* Error constant of the scheme: the local error is K*h^3 times the third derivative. */
+	const double K = (-3.*g*g+4.*g-2.)/(12.*(2.-g));
+	const double qvl = qv[0];
+	const double qvr = qv[SIZE-1];
+	int res = SUCCESS;
+	memcpy(Tn, T, SIZE*sizeof(double));
+	/*
+	 * Embedded estimate (Hosea, Shampine): 2K*(h*f0/g - h*fg/(g*(1-g)) + h*f1/(1-g)).
+	 * The rate f0 comes from an explicit evaluation of the operator, fg and f1
+	 * are recovered from the trapezoidal and BDF2 stage equations.
+	 */
+	memcpy(Est, T, SIZE*sizeof(double));
+	if (recession != 0)
+		GridVelocity(max(recession->velocity(Tn[0]), 0.));
+	tdma.Calculate(Est, w, qv, l, r, c, eps, TIMESTEP, SIZE, 0., 0, (recession != 0) ? u : 0);
+	qv[0] = qvl;
+	qv[SIZE-1] = qvr;
+	for (int i=0; i<SIZE; i++)
+		Est[i] = (Est[i]-Tn[i])*(2.-g)/(g*(1.-g));
+	/* Trapezoidal stage to the time CURRENT_TIME+g*TIMESTEP. */
+	res |= Implicit(T, g*TIMESTEP, 0.5);
+	qv[0] = qvl;
+	qv[SIZE-1] = qvr;
+	/* BDF2 stage to the time CURRENT_TIME+TIMESTEP. */
+	for (int i=0; i<SIZE; i++) {
+		Est[i] -= 2.*(T[i]-Tn[i])/(g*g*(1.-g));
+		T[i] = (T[i]-(1.-g)*(1.-g)*Tn[i])/(g*(2.-g));
+		Est[i] -= (2.-g)/((1.-g)*(1.-g))*T[i];
+	}
+	res |= Implicit(T, (1.-g)/(2.-g)*TIMESTEP);
+	ERR = 0.;
+	if ((res != SUCCESS) && (TIMESTEP > TIMESTEP_MIN))
+		return NEED_SMALLER_STEP;
+	for (int i=0; i<SIZE-1; i++)
+		ERR = max(ERR, fabs(2.*K*(Est[i]+(2.-g)/((1.-g)*(1.-g))*T[i])));
+	ERR /= TOL;
+	return Check(TIMESTEP);
+}
+int CTHSolver::Check(double TIMESTEP)
+{
+	double tempT0 = TWL_PREV;
 	if (TIMESTEP <= TIMESTEP_MIN)
 		return TIMESTEP_MIN_CALCS;
 	if (T[0] <= 0.) {
@@ -143,7 +400,7 @@ int CTHSolver::DoIteration(double TIMESTEP)
 			printf("[EE]: cell %d has T=%lf! Previous T=%lf TIMESTEP=%lf\n", 0, T[0], thm->T[1], TIMESTEP);
 			fflush(NULL);
 	}
-	if ((fabs(T[0]-tempT0) > DT_MAX) && (DT_MAX > 0.))
+	if ((fabs(T[0]-tempT0) > DT_MAX) && (DT_MAX > 0.) && (SCHEME == SCHEME_EULER))
 		return NEED_SMALLER_STEP;
 	sres.CURRENT_DT_MAX = fabs(T[0] - tempT0);
 	
@@ -158,7 +415,7 @@ int CTHSolver::DoIteration(double TIMESTEP)
 		double DT = fabs(T[i]-thm->T[j]);
 		if (DT > sres.CURRENT_DT_MAX)
 			sres.CURRENT_DT_MAX = DT;
-		if ((DT > DT_MAX) && (DT_MAX > 0.))
+		if ((DT > DT_MAX) && (DT_MAX > 0.) && (SCHEME == SCHEME_EULER))
 			return NEED_SMALLER_STEP;
 		if (T[i] < 0.) {
 			print();
@@ -232,12 +489,37 @@ void CTHSolver::setPrefs(double TIMESTEP_MIN, double TIMESTEP_MAX, double DT_MAX
 	this->TIMESTEP_MAX = TIMESTEP_MAX;
 	this->DT_MAX = DT_MAX;
 }
+void CTHSolver::setScheme(int SCHEME, double TOL)
+{
+	assert((SCHEME == SCHEME_EULER) || (SCHEME == SCHEME_TRBDF2));
+	assert(TOL > 0.);
+	this->SCHEME = SCHEME;
+	this->TOL = TOL;
+	this->ERR_PREV = 1.;
+}
+void CTHSolver::setPicard(int ITERS_MAX, double TOL)
+{
+	assert(ITERS_MAX >= 0);
+	assert(TOL > 0.);
+	this->PICARD_ITERS_MAX = ITERS_MAX;
+	this->PICARD_TOL = TOL;
+}
+void CTHSolver::setRecession(CRecession* recession)
+{
+	this->recession = recession;
+	this->VREC = 0.;
+}
 void CTHSolver::printPreferences()
 {
 	printf("SOLVER PREFERENCES:\n");
 	printf("CURRENT_TIME=%lf\n", thm->CURRENT_TIME);
 	printf("TIMESTEP_MIN=%E\n", TIMESTEP_MIN);
 	printf("TIMESTEP_MAX=%E\n", TIMESTEP_MAX);
+	printf("SCHEME=%s\n", (SCHEME == SCHEME_EULER) ? "EULER" : "TR-BDF2");
+	if (SCHEME != SCHEME_EULER)
+		printf("TOL=%E\n", TOL);
+	if (PICARD_ITERS_MAX > 0)
+		printf("PICARD: ITERS_MAX=%d TOL=%E\n", PICARD_ITERS_MAX, PICARD_TOL);
 }
 double CTHSolver::Twl()
 {
@@ -249,10 +531,16 @@ double CTHSolver::Twr()
 }
 double CTHSolver::currentHeatQty()
 {
-	double sum =  w[0]*thm->m[thm->fcnum]->heatQuantity(T[0]);
-	for (int i=1; i<SIZE-1; i++)
-		sum += w[i]*thm->m[thm->fcnum+i-1]->heatQuantity(T[i]);
-	sum +=  w[SIZE-1]*thm->m[thm->lcnum]->heatQuantity(T[SIZE-1]);
+	double sum =  w[0]*thm->material(thm->fcnum)->heatQuantity(T[0]);
+	for (size_t k=0; k<thm->layers.size(); k++) {
+		const layer_t& layer = thm->layers[k];
+		int first = max(layer.first, thm->fcnum);
+		if (first > layer.last)
+			continue;
+		int j = first-thm->fcnum+1;
+		sum += layer.M->heatQuantity(&(T[j]), &(w[j]), layer.last-first+1);
+	}
+	sum +=  w[SIZE-1]*thm->material(thm->lcnum)->heatQuantity(T[SIZE-1]);
 	return sum;
 }
 void CTHSolver::print(FILE* out)
@@ -278,3 +566,94 @@ void CTHSolver::print(FILE* out)
 		fprintf(out, "%5.3E ", r[i]);
 	fprintf(out, "\n");
 }
+
+CTHSolverPack::CTHSolverPack(int capacity) : batch(capacity)
+{
+	COUNT = 0;
+}
+int CTHSolverPack::add(CTHSolver* solver)
+{
+	assert(solver != 0);
+	if ((COUNT == TDMA_LANES) || (solver->SCHEME != SCHEME_EULER) || (solver->PICARD_ITERS_MAX > 0) ||
+			(solver->recession != 0))
+		return NULL_VALUE;
+	this->solver[COUNT] = solver;
+	return COUNT++;
+}
+void CTHSolverPack::clear()
+{
+	COUNT = 0;
+}
+int CTHSolverPack::capacity() const
+{
+	return batch.capacity();
+}
+int CTHSolverPack::count() const
+{
+	return COUNT;
+}
+void CTHSolverPack::Solve(double time, solve_result_t* res)
+{
+	double HeatQty_Pre[TDMA_LANES];
+	double twlk[TDMA_LANES];
+	double twrk[TDMA_LANES];
+	assert(COUNT > 0);
+	const double dt = time - solver[0]->thm->CURRENT_TIME;
+	double TIMESTEP_MIN = solver[0]->TIMESTEP_MIN;
+	double TIMESTEP_MAX = solver[0]->TIMESTEP_MAX;
+	assert(dt > 0.);
+	for (int k=0; k<COUNT; k++) {
+		assert(solver[k]->thm->CURRENT_TIME == solver[0]->thm->CURRENT_TIME);
+		TIMESTEP_MIN = min(TIMESTEP_MIN, solver[k]->TIMESTEP_MIN);
+		TIMESTEP_MAX = min(TIMESTEP_MAX, solver[k]->TIMESTEP_MAX);
+		solver[k]->Begin();
+	}
+	double TIMESTEP = dt;
+	while (solver[0]->thm->CURRENT_TIME < time) {
+		const double CURRENT_TIME = solver[0]->thm->CURRENT_TIME;
+		const int SIZE = solver[0]->SIZE;
+		const bool isBatch = (SIZE <= batch.capacity());
+		bool isAssembled = false;
+		for (int k=0; k<COUNT; k++) {
+			CTHSolver* s = solver[k];
+			HeatQty_Pre[k] = s->Pre(CURRENT_TIME);
+			twlk[k] = s->Twl();
+			twrk[k] = s->Twr();
+			s->TWL_PREV = s->T[0];
+			if (isBatch && (s->SIZE == SIZE)) {
+				batch.Assemble(k, s->T, s->w, s->qv, s->l, s->r, s->c, s->eps, TIMESTEP, SIZE);
+				isAssembled = true;
+			} else
+				s->tdma.Calculate(s->T, s->w, s->qv, s->l, s->r, s->c, s->eps, TIMESTEP, s->SIZE);
+		}
+		if (isAssembled)
+			batch.Solve(SIZE);
+		int result = SUCCESS;
+		for (int k=0; k<COUNT; k++) {
+			CTHSolver* s = solver[k];
+			if (isBatch && (s->SIZE == SIZE))
+				batch.Result(k, s->T, SIZE);
+			int r = s->Check(TIMESTEP);
+			if (r == NEED_SMALLER_STEP)
+				result = r;
+			else if (result == SUCCESS)
+				result = r;
+		}
+		if (result == NEED_SMALLER_STEP) {
+			for (int k=0; k<COUNT; k++)
+				solver[k]->Prepare();
+			if (TIMESTEP > TIMESTEP_MIN)
+				TIMESTEP = TIMESTEP/2.;
+			continue;
+		}
+		for (int k=0; k<COUNT; k++)
+			solver[k]->Accept(TIMESTEP, HeatQty_Pre[k], twlk[k], twrk[k]);
+		TIMESTEP = min(TIMESTEP*1.1, TIMESTEP_MAX);
+		TIMESTEP = min(TIMESTEP, time-solver[0]->thm->CURRENT_TIME);
+	}
+	for (int k=0; k<COUNT; k++) {
+		solver[k]->Finish(dt);
+		if (res != 0)
+			res[k] = solver[k]->sres;
+	}
+}
@@ -0,0 +1,154 @@
+#include <uncertainty.h>
+#include <threadpool.h>
+#include <string>
+#include <algorithm>
+
+/**
+ * @brief Расчёт реализаций метода Монте-Карло.
+ * @details Реализация рассчитывается своим решателем на возмущённых копиях
+ * траектории и тепловой модели. Результаты записываются по номеру реализации
+ * и не зависят от количества потоков и порядка расчёта. Реализация, которую
+ * невозможно рассчитать, отмечается и не прерывает расчёт остальных.
+ */
+class CMonteCarloTask : public CTask {
+	/** Неопределённые параметры. */
+	const CMonteCarlo& mc;
+	/** Настройки решателей. */
+	const options_t& opt;
+	/** Номинальные траектория и тепловая модель. */
+	trm_t* trm;
+	thm_t* thm;
+	/** Газодинамика точки. */
+	gasdynamics_t* gd;
+	/** Геометрия ЛА. */
+	CBluntedCone* BCone;
+	/** Параметры печати. */
+	const print_t& prn;
+public:
+	/** Количество результатов реализации: температуры поверхностей и печатаемых ячеек, унос. */
+	const int COLUMNS;
+	/** Значения параметров реализаций, mc.count() на реализацию. */
+	vector<double> values;
+	/**
+	 * Результаты реализаций, COLUMNS на реализацию: максимальные по шагам печати
+	 * температуры нагреваемой и тыльной поверхностей и печатаемых ячеек, К,
+	 * и унос в конце расчёта, мм.
+	 */
+	vector<double> results;
+	/** Реализацию невозможно рассчитать, её результаты не определены. */
+	vector<char> FAILED;
+	CMonteCarloTask(const CMonteCarlo& mc, const options_t& opt, trm_t* trm, thm_t* thm, gasdynamics_t* gd,
+		CBluntedCone* BCone, const print_t& prn, int samples) :
+		mc(mc), opt(opt), trm(trm), thm(thm), gd(gd), BCone(BCone), prn(prn), COLUMNS(prn.PRINT_CELLS_NUM+3)
+	{
+		values.resize(samples*mc.count());
+		results.resize(samples*COLUMNS);
+		FAILED.assign(samples, 0);
+	}
+	virtual void run(int index, int thread)
+	{
+		double* v = &(values[index*mc.count()]);
+		double* r = &(results[index*COLUMNS]);
+		mc.sample(index, v);
+		CRealisation real(mc, v, trm, thm, opt.FLUX);
+		AVDSolver solver(&real.thm, &real.trm, gd, BCone);
+		if (configure(&solver, &real.thm, opt, prn) != SUCCESS) {
+			FAILED[index] = 1;
+			return;
+		}
+		solver.setHeatFlux(&real.flux);
+		real.thm.CURRENT_TIME = trm->BEGIN_TIME;
+		r[0] = real.thm.TWL;
+		r[1] = real.thm.TWR;
+		for (int i=0; i<prn.PRINT_CELLS_NUM; i++)
+			r[i+2] = real.thm.cellT(prn.PRINT_CELLS[i]-1);
+		for (double time = trm->BEGIN_TIME+prn.print_interval; (real.thm.CURRENT_TIME < trm->END_TIME); time += min(prn.print_interval, trm->END_TIME-time)) {
+			if (solver.Solve(time).STATUS != SUCCESS) {
+				FAILED[index] = 1;
+				return;
+			}
+			r[0] = max(r[0], real.thm.TWL);
+			r[1] = max(r[1], real.thm.TWR);
+			for (int i=0; i<prn.PRINT_CELLS_NUM; i++)
+				r[i+2] = max(r[i+2], real.thm.cellT(prn.PRINT_CELLS[i]-1));
+		}
+		r[COLUMNS-1] = real.thm.LDEL*1000.;
+	}
+};
+
+void monte_carlo(const char* filename, int samples, uint64_t seed, FILE* fout, const options_t& opt,
+	trm_t* trm, thm_t* thm, gasdynamics_t* gd, CBluntedCone* BCone, const print_t& prn)
+{
+	char name[FILENAME_MAX_LEN];
+	CMonteCarlo mc(filename, seed);
+	if (mc.check(thm, trm) != SUCCESS) {
+		printf("[EE]: Uncertain parameters of %s don't fit the model or the trajectory\n", filename);
+		exit(-1);
+	}
+	CThreadPool pool;
+	CMonteCarloTask task(mc, opt, trm, thm, gd, BCone, prn, samples);
+	printf("MONTE CARLO: %d SAMPLES, %d PARAMETERS, %d THREADS\n", samples, mc.count(), pool.size());
+	pool.run(&task, samples);
+	/* Названия результатов. */
+	vector<string> columns;
+	columns.push_back("T1");
+	columns.push_back("T2");
+	for (int i=0; i<prn.PRINT_CELLS_NUM; i++) {
+		sprintf(name, "CELL%d", prn.PRINT_CELLS[i]);
+		columns.push_back(name);
+	}
+	columns.push_back("DY");
+	fprintf(fout, "\n--- MONTE CARLO ---\n");
+	fprintf(fout, "\nSAMPLES: %d SEED: %llu\n", samples, (unsigned long long)seed);
+	fprintf(fout, "\n%7.7s\t", "N");
+	for (int k=0; k<mc.count(); k++) {
+		mc.name(k, name);
+		fprintf(fout, "%11.11s\t", name);
+	}
+	for (int j=0; j<task.COLUMNS; j++)
+		fprintf(fout, "%7.7s\t", columns[j].c_str());
+	fprintf(fout, "\n");
+	for (int n=0; n<samples; n++) {
+		fprintf(fout, "%7d\t", n);
+		for (int k=0; k<mc.count(); k++)
+			fprintf(fout, "%11.5lf\t", task.values[n*mc.count()+k]);
+		if (task.FAILED[n]) {
+			fprintf(fout, "FAILED\n");
+			continue;
+		}
+		for (int j=0; j<task.COLUMNS; j++)
+			fprintf(fout, "%7.1lf\t", task.results[n*task.COLUMNS+j]);
+		fprintf(fout, "\n");
+	}
+	/* Статистика - по рассчитанным реализациям. */
+	int failed = (int)count(task.FAILED.begin(), task.FAILED.end(), 1);
+	const int good = samples-failed;
+	fprintf(fout, "\n--- STATISTICS ---\n");
+	if (failed > 0) {
+		fprintf(fout, "\nFAILED: %d OF %d SAMPLES\n", failed, samples);
+		printf("MONTE CARLO: %d OF %d SAMPLES FAILED\n", failed, samples);
+	}
+	if (good == 0)
+		return;
+	fprintf(fout, "\n%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\n", "", "MEAN", "SIGMA", "MEAN+3S", "MIN", "MAX");
+	printf("\n%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\t%7.7s\n", "", "MEAN", "SIGMA", "MEAN+3S", "MIN", "MAX");
+	for (int j=0; j<task.COLUMNS; j++) {
+		double sum = 0., sum2 = 0.;
+		double lo = HUGE_VAL, hi = -HUGE_VAL;
+		for (int n=0; n<samples; n++) {
+			if (task.FAILED[n])
+				continue;
+			double x = task.results[n*task.COLUMNS+j];
+			sum += x;
+			lo = min(lo, x);
+			hi = max(hi, x);
+		}
+		double mean = sum/good;
+		for (int n=0; n<samples; n++)
+			if (!task.FAILED[n])
+				sum2 += pow(task.results[n*task.COLUMNS+j]-mean, 2);
+		double sigma = (good > 1) ? sqrt(sum2/(good-1)) : 0.;
+		fprintf(fout, "%7.7s\t%7.1lf\t%7.1lf\t%7.1lf\t%7.1lf\t%7.1lf\n", columns[j].c_str(), mean, sigma, mean+3.*sigma, lo, hi);
+		printf("%7.7s\t%7.1lf\t%7.1lf\t%7.1lf\t%7.1lf\t%7.1lf\n", columns[j].c_str(), mean, sigma, mean+3.*sigma, lo, hi);
+	}
+}
@@ -0,0 +1,289 @@
+#include <common.h>
+#include <avdrun.h>
+#include <atmosphere.h>
+#include <cstring>
+#include <ctime>
+
+/** Parsed input files of the checks. */
+typedef struct {
+	trm_t* trm;
+	thm_t* thm;
+	CBluntedCone* BCone;
+	gasdynamics_t gd;
+	print_t prn;
+} input_t;
+
+/**
+ * @brief Heat flux of the checks.
+ * @details Table with knots every 50 s from 0 to 950 s, which rises from
+ * 1.0E+05 to 7.0E+05 W/m^2 by 1.0E+05 per knot and repeats every 7 knots,
+ * interpolated linearly. The heat transfer coefficient follows from the
+ * enthalpies of the kernel, as for CTableHeatFlux.
+ */
+class CStepHeatFlux : public CHeatFlux {
+public:
+	virtual void apply(double time, avd_t* avd, int*) const
+	{
+		int k = min(max((int)floor(time/50.), 0), 18);
+		avd->QCONV = in_linear(50.*k, 1.0E+05*(1+k%7), 50.*(k+1), 1.0E+05*(1+(k+1)%7), min(time, 950.));
+		avd->ALC = avd->QCONV/(avd->IE-avd->IW);
+		avd->ALC1 = avd->ALC;
+	}
+};
+
+/** Options of the plain march: Euler scheme, no remeshing. */
+static options_t plain()
+{
+	static const CStepHeatFlux FLUX;
+	options_t opt;
+	opt.SCHEME = SCHEME_EULER;
+	opt.TOL = 1.;
+	opt.TIMESTEP_MAX = 0.;
+	opt.PICARD_TOL = 0.;
+	opt.REMESH_DT = 0.;
+	opt.MOVING = false;
+	opt.MEMO_DT = 0.;
+	opt.MEMO_DTW = 0.;
+	opt.FLUX = &FLUX;
+	return opt;
+}
+
+/** Result of a march over the whole trajectory. */
+typedef struct {
+	/** Processor time of the march, s. */
+	double CPU;
+	/** Maximum number of cells at the print steps. */
+	int CELLS;
+	/** The storage of the model was reallocated during the march. */
+	bool GROWN;
+} march_t;
+
+/**
+ * @brief March a copy of the model over the whole trajectory.
+ * @param trace - if not 0, T1, T2, DY and ALC1 at the print steps are appended.
+ */
+static march_t march(input_t& in, const options_t& opt, vector<double>* trace = 0)
+{
+	march_t m;
+	thm_t thm(*in.thm);
+	AVDSolver solver(&thm, in.trm, &in.gd, in.BCone);
+	if (configure(&solver, &thm, opt, in.prn) != SUCCESS)
+		exit(-1);
+	thm.CURRENT_TIME = in.trm->BEGIN_TIME;
+	const int CAPACITY = thm.capacity();
+	m.CELLS = thm.lcnum-thm.fcnum+1;
+	clock_t start = clock();
+	for (double time = in.trm->BEGIN_TIME+in.prn.print_interval; (thm.CURRENT_TIME < in.trm->END_TIME); time += min(in.prn.print_interval, in.trm->END_TIME-time)) {
+		avdsolver_t info = solver.Solve(time);
+		assert(info.STATUS == SUCCESS);
+		m.CELLS = max(m.CELLS, thm.lcnum-thm.fcnum+1);
+		if (trace != 0) {
+			trace->push_back(thm.TWL);
+			trace->push_back(thm.TWR);
+			trace->push_back(thm.LDEL*1000.);
+			trace->push_back(info.avd.ALC1);
+		}
+	}
+	m.CPU = (double)(clock()-start)/CLOCKS_PER_SEC;
+	m.GROWN = (thm.capacity() != CAPACITY);
+	return m;
+}
+
+/** Keep the best processor time and the worst mesh of two marches. */
+static void best(march_t* m, const march_t& n)
+{
+	m->CPU = min(m->CPU, n.CPU);
+	m->CELLS = max(m->CELLS, n.CELLS);
+	m->GROWN = m->GROWN || n.GROWN;
+}
+
+/** Repetitions of the timed marches. */
+#define REPEATS	(5)
+
+/**
+ * Allowed slowdown of the march with remeshing: the refined surface cells
+ * take up to 10% more steps, the rest is the margin for the timing noise.
+ */
+#define REMESH_SLOWDOWN	(1.25)
+
+/**
+ * The adaptive mesh never has more cells than the initial one, and the march
+ * with remeshing is not slower than on the initial mesh.
+ */
+static bool check_remesh(input_t& in)
+{
+	const int N = in.thm->lcnum-in.thm->fcnum+1;
+	options_t opt = plain();
+	bool ok = true;
+	const double DT[] = {1., 5., 20.};
+	for (size_t k=0; k<sizeof(DT)/sizeof(DT[0]); k++) {
+		opt.REMESH_DT = DT[k];
+		/* The marches alternate, so a change of the machine load affects both. */
+		march_t base = march(in, plain());
+		march_t m = march(in, opt);
+		for (int r=1; r<REPEATS; r++) {
+			best(&base, march(in, plain()));
+			best(&m, march(in, opt));
+		}
+		bool passed = (m.CELLS <= N) && !m.GROWN && (m.CPU <= REMESH_SLOWDOWN*base.CPU);
+		printf("remesh %4.1lf K: %d cells of %d, %.3lf s vs %.3lf s: %s\n", DT[k], m.CELLS, N, m.CPU, base.CPU,
+			passed ? "OK" : "FAILED");
+		ok = ok && passed;
+	}
+	return ok;
+}
+
+/** Quanta of the memo check: coarse and fine, s and K. */
+static const double MEMO_QUANTA[2][2] = {{1., 10.}, {0.1, 2.}};
+
+/** Allowed difference of the fine quanta from the uncached march: T1, T2 (K) and DY (mm). */
+static const double MEMO_TOL[3] = {1., 1., 0.01};
+
+/** Allowed relative difference of ALC1 of the level flight from the uncached march. */
+#define MEMO_ALC1_TOL	(1.0E-6)
+
+/** Values of the march trace per print step: T1, T2, DY and ALC1. */
+#define TRACE_VALUES	(4)
+
+/**
+ * The memo with the fine quanta stays within MEMO_TOL of the uncached march
+ * with the Avduevsky heat flux on the moving grid, and the difference is of
+ * the first order: ten times finer quanta make it at least four times less.
+ * In the level flight the whole march is one time quantum, and ALC1 follows
+ * the recession of the uncached march.
+ */
+static bool check_memo(input_t& in)
+{
+	static const char* NAMES[3] = {"T1", "T2", "DY"};
+	options_t opt = plain();
+	opt.FLUX = 0;
+	opt.MOVING = true;
+	vector<double> base;
+	march(in, opt, &base);
+	double diff[2][3] = {{0., 0., 0.}, {0., 0., 0.}};
+	for (int q=0; q<2; q++) {
+		vector<double> trace;
+		opt.MEMO_DT = MEMO_QUANTA[q][0];
+		opt.MEMO_DTW = MEMO_QUANTA[q][1];
+		march(in, opt, &trace);
+		assert(trace.size() == base.size());
+		for (size_t k=0; k<base.size(); k++)
+			if (k%TRACE_VALUES < 3)
+				diff[q][k%TRACE_VALUES] = max(diff[q][k%TRACE_VALUES], fabs(trace[k]-base[k]));
+	}
+	bool ok = true;
+	for (int j=0; j<3; j++) {
+		bool passed = (diff[1][j] <= MEMO_TOL[j]) && (diff[1][j] <= diff[0][j]/4.);
+		printf("memo %s: %.3lf at %g s, %g K, %.3lf at %g s, %g K: %s\n", NAMES[j], diff[0][j], MEMO_QUANTA[0][0], MEMO_QUANTA[0][1],
+			diff[1][j], MEMO_QUANTA[1][0], MEMO_QUANTA[1][1], passed ? "OK" : "FAILED");
+		ok = ok && passed;
+	}
+	/* Level flight: the free stream is the same all the time. */
+	trm_t trm = *in.trm;
+	for (int i=0; i<trm.POINTS_NUM; i++) {
+		trm.V.set(&i, 7200.);
+		trm.H.set(&i, 68000.);
+	}
+	input_t level = in;
+	level.trm = &trm;
+	vector<double> trace;
+	opt.MEMO_DT = 0.;
+	base.clear();
+	march(level, opt, &base);
+	opt.MEMO_DT = trm.END_TIME-trm.BEGIN_TIME;
+	opt.MEMO_DTW = MEMO_QUANTA[1][1];
+	march(level, opt, &trace);
+	assert(trace.size() == base.size());
+	double d = 0.;
+	for (size_t k=3; k<base.size(); k+=TRACE_VALUES)
+		d = max(d, fabs(trace[k]-base[k])/base[k]);
+	bool passed = (d <= MEMO_ALC1_TOL);
+	printf("memo ALC1 of the level flight: %.1E: %s\n", d, passed ? "OK" : "FAILED");
+	return ok && passed;
+}
+
+/** Radius of the Earth of the geopotential altitude in BCA, m. */
+#define BCA_RE	(6356766.0)
+
+/** Maximum relative difference of the four arrays of atmosphere parameters. */
+static double bca_diff(const double* a, const double* b, int n)
+{
+	double d = 0.;
+	for (int k=0; k<n; k++)
+		d = max(d, fabs(a[k]-b[k])/fabs(b[k]));
+	return d;
+}
+
+/**
+ * The array BCA gives the same values as the scalar one at the nodes of the
+ * dense table and at the midpoints between them, with the table and without
+ * it, and the table is within its own error estimate of the layers.
+ */
+static bool check_atmosphere(input_t&)
+{
+	const double STEP = 10.;
+	const double H0 = BCA_RE*(-2000.)/(BCA_RE-2000.);
+	const double H1 = BCA_RE*150000./(BCA_RE+150000.);
+	const int n = 2*(int)floor((H1-H0)/STEP);
+	/* Geometric altitudes of the nodes and the midpoints of the table. */
+	std::vector<double> H(n);
+	for (int k=0; k<n; k++) {
+		double h = H0+0.5*k*STEP;
+		H[k] = BCA_RE*h/(BCA_RE-h);
+	}
+	std::vector<double> table(4*n), layers(4*n), scalar(4*n);
+	const double STEPS[] = {STEP, 0.};
+	bool ok = true;
+	double err = 0.;
+	for (int m=0; m<2; m++) {
+		std::vector<double>& v = (STEPS[m] > 0.) ? table : layers;
+		err = max(err, BCA_Dense(STEPS[m]));
+		BCA(&(H[0]), n, &(v[0]), &(v[n]), &(v[2*n]), &(v[3*n]));
+		for (int k=0; k<n; k++)
+			BCA(H[k], &(scalar[k]), &(scalar[n+k]), &(scalar[2*n+k]), &(scalar[3*n+k]));
+		double d = bca_diff(&(v[0]), &(scalar[0]), 4*n);
+		bool passed = (d <= 1.0E-14);
+		printf("atmosphere %s: %d altitudes, array vs scalar %.1E: %s\n", (STEPS[m] > 0.) ? "table" : "layers", n, d,
+			passed ? "OK" : "FAILED");
+		ok = ok && passed;
+	}
+	/* The error is estimated at the quarters of the intervals, at the midpoints it is 4/3 of that. */
+	double d = bca_diff(&(table[0]), &(layers[0]), 4*n);
+	bool passed = (d <= 1.5*err);
+	printf("atmosphere table vs layers %.1E of %.1E: %s\n", d, err, passed ? "OK" : "FAILED");
+	ok = ok && passed;
+	BCA_Dense(0.);
+	return ok;
+}
+
+/** Checks by name. */
+static const struct {
+	const char* name;
+	bool (*run)(input_t&);
+} CHECKS[] = {{"remesh", check_remesh}, {"atmosphere", check_atmosphere}, {"memo", check_memo}};
+
+int main(int argc, char *argv[])
+{
+	input_t in;
+	if (argc < 3) {
+		printf("INCORRECT PROGRAM USAGE!\n");
+		printf("avdtest TRAJECTORY TPS [CHECK...]\n");
+		exit(-1);
+	}
+	FILE* flog = tmpfile();
+	assert(flog != 0);
+	in.trm = trm_parse(argv[1], flog);
+	in.thm = thm_parse(argv[2], flog, &in.BCone, &in.gd, &in.prn);
+	fclose(flog);
+	in.thm->setRBC(new CSOBoundary(0., 0., 0., 0., 0.));
+	int failed = 0;
+	for (size_t k=0; k<sizeof(CHECKS)/sizeof(CHECKS[0]); k++) {
+		bool isSelected = (argc == 3);
+		for (int i=3; i<argc; i++)
+			isSelected = isSelected || (strcmp(argv[i], CHECKS[k].name) == 0);
+		if (isSelected && !CHECKS[k].run(in))
+			failed++;
+	}
+	printf("%s\n", (failed == 0) ? "ALL CHECKS PASSED" : "CHECKS FAILED");
+	return (failed == 0) ? 0 : 1;
+}
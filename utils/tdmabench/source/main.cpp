@@ -0,0 +1,92 @@
+#include <common.h>
+#include <tdma.h>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+/** Model arrays of one system. */
+typedef struct {
+	vector<double> T, w, qv, l, r, c;
+	double eps[2];
+} system_t;
+
+static double rnd(double a, double b)
+{
+	return a + (b-a)*rand()/(double)RAND_MAX;
+}
+
+static void init(system_t* s, int cells)
+{
+	s->T.resize(cells); s->w.resize(cells); s->qv.resize(cells);
+	s->l.resize(cells); s->r.resize(cells); s->c.resize(cells);
+	for (int i=0; i<cells; i++) {
+		s->T[i] = rnd(280., 2000.);
+		s->w[i] = rnd(1.0E-4, 1.0E-3);
+		s->qv[i] = 0.;
+		s->l[i] = rnd(0.1, 20.);
+		s->r[i] = rnd(1000., 8000.);
+		s->c[i] = rnd(500., 2000.);
+	}
+	s->qv[0] = rnd(1.0E+5, 1.0E+6)/s->w[0];
+	s->eps[0] = rnd(0., 1.);
+	s->eps[1] = rnd(0., 1.);
+}
+
+static double seconds()
+{
+	return (double)clock()/CLOCKS_PER_SEC;
+}
+
+int main(int argc, char *argv[])
+{
+	int SYSTEMS = (argc > 1) ? atoi(argv[1]) : 256;
+	int CELLS = (argc > 2) ? atoi(argv[2]) : 200;
+	int REPEATS = (argc > 3) ? atoi(argv[3]) : 200;
+	const double thau = 0.01;
+
+	if ((SYSTEMS <= 0) || (CELLS <= 2) || (REPEATS <= 0)) {
+		printf("INCORRECT PROGRAM USAGE!\n");
+		exit(-1);
+	}
+	SYSTEMS = ((SYSTEMS+TDMA_LANES-1)/TDMA_LANES)*TDMA_LANES;
+	srand(1);
+	vector<system_t> src(SYSTEMS), scalar(SYSTEMS), batched(SYSTEMS);
+	for (int k=0; k<SYSTEMS; k++)
+		init(&src[k], CELLS);
+
+	CTDMASolver tdma(CELLS);
+	double t0 = seconds();
+	for (int n=0; n<REPEATS; n++)
+		for (int k=0; k<SYSTEMS; k++) {
+			scalar[k] = src[k];
+			tdma.Calculate(&scalar[k].T[0], &scalar[k].w[0], &scalar[k].qv[0], &scalar[k].l[0],
+					&scalar[k].r[0], &scalar[k].c[0], scalar[k].eps, thau, CELLS);
+		}
+	double tScalar = seconds()-t0;
+
+	CTDMABatch batch(CELLS);
+	t0 = seconds();
+	for (int n=0; n<REPEATS; n++)
+		for (int k0=0; k0<SYSTEMS; k0+=TDMA_LANES) {
+			for (int k=k0; k<k0+TDMA_LANES; k++) {
+				batched[k] = src[k];
+				batch.Assemble(k-k0, &batched[k].T[0], &batched[k].w[0], &batched[k].qv[0], &batched[k].l[0],
+						&batched[k].r[0], &batched[k].c[0], batched[k].eps, thau, CELLS);
+			}
+			batch.Solve(CELLS);
+			for (int k=k0; k<k0+TDMA_LANES; k++)
+				batch.Result(k-k0, &batched[k].T[0], CELLS);
+		}
+	double tBatch = seconds()-t0;
+
+	double err = 0.;
+	for (int k=0; k<SYSTEMS; k++)
+		for (int i=0; i<CELLS; i++)
+			err = MAX(err, fabs(scalar[k].T[i]-batched[k].T[i]));
+	printf("SYSTEMS=%d CELLS=%d REPEATS=%d LANES=%d\n", SYSTEMS, CELLS, REPEATS, TDMA_LANES);
+	printf("%10.10s\t%10.10s\t%10.10s\n", "METHOD", "TIME, s", "SPEEDUP");
+	printf("%10.10s\t%10.4lf\t%10.2lf\n", "SCALAR", tScalar, 1.);
+	printf("%10.10s\t%10.4lf\t%10.2lf\n", "BATCH", tBatch, tScalar/tBatch);
+	printf("MAX |T(SCALAR)-T(BATCH)| = %E\n", err);
+	return 0;
+}